@@ -0,0 +1,6383 @@
+/**
+ * @file myfind.c
+ * Betriebssysteme MyFind
+ * Beispiel 1
+ *
+ * Dies ist das Bibliotheks-Modul (libmyfind) des Programms MyFind, siehe myfind.h
+ *
+ * Es akzeptiert diese möglichen Argumente:
+ * -ls, -user, -name, -type, -nouser, -path, -size, -mtime, -mmin, -newer, -exec, -contains, -dupes, -du.
+ *
+ * Die Expression wird vor der Traversierung einmalig in ein Array von param_t übersetzt (compile_params()),
+ * dabei werden Benutzer aufgelöst und Grenzwerte für Größen- und Zeitvergleiche vorberechnet.
+ *
+ * Die Traversierung verwendet statt Rekursion einen expliziten Stack von Verzeichnissen (frame_t),
+ * damit sie von einem Iterator schrittweise fortgesetzt werden kann (myfind_iter_next()).
+ * Mehrere Start-Verzeichnisse werden nacheinander mit derselben Expression durchsucht, mit parallel_roots
+ * liest pro Gerät ein eigener Thread die Verzeichnisse (siehe walk_start()). Mit prefetch liest ein Hilfs-Thread
+ * die Verzeichnisse und Inodes voraus, damit sie beim Lesen durch die Traversierung bereits im Cache sind.
+ * Zusätzliche Optionen beeinflussen die Art der Traversierung (z.B. inode_order, sort_name, follow).
+ *
+ * Die Funktionsweise ist an das unter Linux verbreitete Programm "find" angelehnt
+ * Es durchsucht das gegebene Verzeichnis nach weiteren Verzeichnissen und Files und
+ * validiert diese gegen eine beliebige Anzahl an Expression-Argumenten um zutreffende
+ * Files und Directories auszugeben. Die Ausgabe kann mit bestimmten Parametern formatiert
+ * werden.
+ *
+ * @author Baliko Markus	    <ic15b001@technikum-wien.at>
+ * @author Haubner Alexander    <ic15b033@technikum-wien.at>
+ * @author Riedmann Michael     <ic15b054@technikum-wien.at>
+ *
+ * @date 2016/03/18
+ *
+ * @version 2.0
+ *
+ */
+
+// -------------------------------------------------------------- includes --
+#define _GNU_SOURCE // memmem()
+
+#include "myfind.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <string.h>
+#include <ctype.h>
+#include <error.h>
+#include <errno.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <libgen.h>
+#include <pwd.h>
+#include <grp.h>
+#include <time.h>
+#include <fnmatch.h>
+
+// -------------------------------------------------------------- defines --
+// the public names in myfind.h carry the prefix MYFIND_, libmyfind uses them without
+#define OK_NOERROR                MYFIND_OK_NOERROR
+#define OK_PROCEED                MYFIND_OK_PROCEED
+#define OK_STOP                   MYFIND_OK_STOP
+#define OK_VALUE_NOTNEEDED        MYFIND_OK_VALUE_NOTNEEDED
+#define OK_VALUE_EXISTS           MYFIND_OK_VALUE_EXISTS
+#define OK_DEFERRED               MYFIND_OK_DEFERRED
+#define ERR_NONCRITICAL           MYFIND_ERR_NONCRITICAL
+#define ERR_TO0_FEW_ARGUMENTS     MYFIND_ERR_TO0_FEW_ARGUMENTS
+#define ERR_INVALID_ARGUMENT      MYFIND_ERR_INVALID_ARGUMENT
+#define ERR_VALUE_UNEXPECTED      MYFIND_ERR_VALUE_UNEXPECTED
+#define ERR_VALUE_MISSING         MYFIND_ERR_VALUE_MISSING
+#define ERR_NO_USER_FOUND         MYFIND_ERR_NO_USER_FOUND
+#define ERR_OUTPUT_BROKEN         MYFIND_ERR_OUTPUT_BROKEN
+#define ERR_INVALID_TYPE_ARGUMENT MYFIND_ERR_INVALID_TYPE_ARGUMENT
+#define ERR_INVALID_PATTERN       MYFIND_ERR_INVALID_PATTERN
+#define ERR_OUT_OF_MEMORY         MYFIND_ERR_OUT_OF_MEMORY
+#define ERR_INVALID_NUMBER        MYFIND_ERR_INVALID_NUMBER
+#define ERR_NO_REFERENCE_FILE     MYFIND_ERR_NO_REFERENCE_FILE
+#define ERR_EXEC_FAILED           MYFIND_ERR_EXEC_FAILED
+#define ERR_NOT_IMPLEMENTED       MYFIND_ERR_NOT_IMPLEMENTED
+#define FOLLOW_NEVER              MYFIND_FOLLOW_NEVER
+#define FOLLOW_ROOTS              MYFIND_FOLLOW_ROOTS
+#define FOLLOW_ALWAYS             MYFIND_FOLLOW_ALWAYS
+
+#define DIR_ENTRIES_INITIAL 64
+#define FRAMES_INITIAL 16
+#define WALK_QUEUE_SIZE 1024 // entries read ahead by the threads of parallel_roots
+#define NAME_CACHE_INITIAL 16
+#define PREFETCH_AHEAD 64 // directories the prefetch thread may read ahead of the traversal
+#define CHECKPOINT_INTERVAL 10              // seconds between two checkpoints
+#define CHECKPOINT_MAGIC "myfind-checkpoint"
+#define CHECKPOINT_VERSION 2
+#define CHECKPOINT_SUFFIX ".tmp"            // the checkpoint is written to FILE.tmp and renamed to FILE
+#define CHECKPOINT_STRING_MAX (1024 * 1024) // longest path accepted from a checkpoint file
+#define THROTTLE_BURSTS 10                  // a rate limit may be used up in bursts of 1/10 second
+#define THROTTLE_DELAY_MIN NSEC_PER_MSEC    // first pause before each directory when the latency rises
+#define THROTTLE_DELAY_MAX NSEC_PER_SEC     // longest pause before each directory
+#define OPTS_COUNT sizeof(OPT_NAME) / sizeof(OPT_NAME[0])
+
+#ifndef DEBUG // to make -DDEBUG gcc flag possible
+#define DEBUG 0
+#endif
+
+#define USERNAME_MAX 255
+#define GROUPNAME_MAX 255
+#define PERMISSIONS_TEXT_SIZE 11
+#define TIME_TEXT_SIZE 80
+
+#define SECONDS_PER_MINUTE 60
+#define SECONDS_PER_DAY 86400
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_MSEC 1000000LL
+#define SIZE_UNIT_BLOCK 512
+
+#define CONTENT_CHUNK_SIZE (1024 * 1024)
+#define CONTENT_QUEUE_PER_THREAD 4
+
+#define DUPES_EDGE_SIZE 4096 // bytes read from the head and the tail of a file for the partial hash
+#define DEVINO_SET_INITIAL 64
+#define DU_NONE SIZE_MAX // no -du directory, e.g. without -du in the expression
+
+#define RX_REPEAT_MAX 255    // largest count of an interval {n,m}, like RE_DUP_MAX
+#define RX_DEPTH_MAX 256     // nesting of groups and repetitions in a -regex pattern
+#define RX_NFA_MAX 16384     // NFA states of a -regex pattern, larger counted repetitions are rejected
+#define RX_DFA_MAX 1024      // cached DFA states of a -regex pattern, the cache is flushed when it is full
+#define RX_NONE SIZE_MAX     // no node in the syntax tree of a -regex pattern
+#define RX_UNKNOWN -1        // DFA transition not computed yet
+#define RX_DEAD -2           // DFA transition to the empty state, the path can't match anymore
+
+#define HASH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME64_3 0x165667B19E3779F9ULL
+#define HASH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define HASH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define EXEC_PLACEHOLDER "{}"
+#define EXEC_ARG_MAX_RESERVE 2048 // headroom for the environment growing, like xargs
+#define EXEC_BATCHES_INITIAL 8
+
+#define ANSI_COLOR_YELLOW "\033[0;33m"
+#define ANSI_COLOR_RESET "\033[0m"
+
+#define debug_print(fmt, ...)                                                                                          \
+    do {                                                                                                               \
+        if (DEBUG)                                                                                                     \
+            fprintf(stdout, ANSI_COLOR_YELLOW fmt ANSI_COLOR_RESET, __VA_ARGS__);                                      \
+    } while (0)
+
+#define check_flags(mode, flags) (mode & flags) == flags
+#define rx_has(bytes, c) (((bytes)->bits[(c) >> 6] >> ((c)&63)) & 1)
+#define rx_set(bytes, c) ((bytes)->bits[(c) >> 6] |= 1ULL << ((c)&63))
+#define timespec_to_ns(ts) ((int64_t)(ts)->tv_sec * NSEC_PER_SEC + (ts)->tv_nsec)
+
+// -------------------------------------------------------------- typedefs --
+
+/**
+ * \brief Interne Namen der öffentlichen Typen (siehe myfind.h)
+ */
+typedef myfind_retval_t retval_t;
+typedef myfind_follow_t follow_t;
+
+/**
+ * OPT
+ * \brief Wird für die schnellere Verarbeitung der Argumente verwendet.
+ *
+ * Jeder Eintrag bezieht sich mit seinem Wert auf einen Eintrag im OPT_NAME-Array
+ */
+typedef enum OPT {
+    INVALID = 0, //!< invalid opt. Wird zur überprüfung verwendet
+    PRINT = 1,   //!< output print. Gibt den Namen des gefundenen Elements über stdout aus
+    LS = 2,      //!< output list. Gibt pro gefundenes Element eine formatierte Tabellenzeile aus
+    USER = 3,    //!< filter by fileowner. Filtert die Ausgabe auf einen angegebenen File-Owner
+    NAME = 4,    //!< filter by filename. Filtert die Ausgabe über ein angegebenes Filename-Pattern
+    TYPE = 5,    //!< filter by filetype. Filtert die Ausgabe über einen angegebenen Filetype
+    NOUSER = 6,  //!< filter by no valid fileowner. Gibt Files aus die keinen gültigen Besitzer haben.
+    PATH = 7,    //!< filter by path. Filtert die Ausgabe auf Files die einen Pfad besitzer der einem Pattern entspricht
+    SIZE = 8,    //!< filter by size. Filtert die Ausgabe über die Dateigröße (+n, -n, n mit Einheit [bcwkMG])
+    MTIME = 9,   //!< filter by modification time. Filtert über das Alter der letzten Änderung in Tagen
+    MMIN = 10,   //!< filter by modification time. Filtert über das Alter der letzten Änderung in Minuten
+    NEWER = 11,  //!< filter by reference file. Gibt Files aus die nach einer Referenz-Datei geändert wurden
+    EXEC = 12,   //!< action execute. Führt ein Kommando pro Datei (;) oder für viele Dateien gemeinsam (+) aus
+    CONTAINS = 13, //!< filter by content. Gibt reguläre Dateien aus die eine Zeichenkette enthalten
+    DUPES = 14,    //!< action duplicates. Gibt nach der Traversierung Gruppen von Dateien mit gleichem Inhalt aus
+    DU = 15,       //!< action disk usage. Gibt nach der Traversierung den belegten Platz pro Verzeichnis aus
+    REGEX = 16,    //!< filter by regular expression. Der ganze Pfad muss einer Extended Regular Expression entsprechen
+    IREGEX = 17,   //!< filter by regular expression. Wie -regex aber ohne Unterscheidung von Groß- und Kleinschreibung
+    QUIT = 18,     //!< action quit. Beendet die Traversierung nach der aktuellen Datei
+    LIMIT = 19     //!< action limit. Beendet die Traversierung nachdem n Dateien das Argument erreicht haben
+} opt_t;
+
+/**
+ * \brief Wird als pseudo-interface für die parameter-verarbeitungs Funktionen verwendet
+ *
+ * Dieses Context-Struct wird in der Funktion do_params erstellt und dient dazu einheitliche Arbeitsinformationen
+ * über das aktuelle File oder Directory an die weiteren Funktionen durchreichen zu können.
+ */
+typedef struct PARAM_CONTEXT {
+    const char *file_name;        //!< pfad der zu bearbeitenden Datei
+    const struct stat *file_stat; //!< metadaten der Datei
+    size_t dir;                   //!< Index des Verzeichnisses in der -du Tabelle dem die Datei zugerechnet wird
+} param_context_t;
+
+/**
+ * \brief Ein zwischengespeicherter Verzeichniseintrag für die sortierte Verarbeitung in do_dir_sorted()
+ */
+typedef struct DIR_ENTRY {
+    char *name;        //!< Name des Eintrags (ohne Pfad)
+    ino_t ino;         //!< Inode-Nummer laut readdir()
+    struct stat stat;  //!< metadaten des Eintrags (nur gültig wenn stat_errno == 0)
+    int stat_errno;    //!< Fehler von lstat() oder -1 wenn noch kein lstat() durchgeführt wurde
+} dir_entry_t;
+
+/**
+ * \brief Ein Verzeichnis auf dem Stack der Traversierung
+ *
+ * Die Einträge werden entweder direkt aus dem Directory-Stream gelesen oder wurden von do_dir_sorted()
+ * bereits gepuffert, dann ist der Stream schon geschlossen.
+ */
+typedef struct FRAME {
+    char *path;           //!< Pfad des Verzeichnisses
+    DIR *dirp;            //!< offener Directory-Stream oder NULL wenn die Einträge gepuffert sind
+    dir_entry_t *entries; //!< gepufferte Einträge (inode_order, sort_name)
+    size_t count;         //!< Anzahl der gepufferten Einträge
+    size_t next;          //!< Index des nächsten gepufferten Eintrags
+    dev_t dev;            //!< Gerät des Verzeichnisses (für die Erkennung von Schleifen)
+    ino_t ino;            //!< Inode-Nummer des Verzeichnisses (für die Erkennung von Schleifen)
+    size_t du_dir;        //!< Index des Verzeichnisses in der -du Tabelle oder DU_NONE
+    int64_t read_time;    //!< bisherige Zeit in opendir() und readdir() (nur mit Begrenzung bzw. --stats)
+} frame_t;
+
+/**
+ * \brief Ein Treffer der noch nicht vom Iterator abgeholt wurde
+ */
+typedef struct MATCH {
+    char *path;       //!< Pfad der Datei
+    struct stat stat; //!< metadaten der Datei
+} match_t;
+
+/**
+ * \brief Verwaltet die von -exec gestarteten Prozesse
+ *
+ * Asynchron gestartete Kommandos laufen parallel zur Traversierung weiter,
+ * es laufen aber nie mehr als max_jobs Prozesse gleichzeitig.
+ */
+typedef struct EXEC_POOL {
+    unsigned long max_jobs; //!< maximale Anzahl gleichzeitig laufender Prozesse
+    unsigned long running;  //!< Anzahl der noch nicht abgeholten asynchronen Prozesse
+    bool failed;            //!< true wenn ein -exec ... + Kommando fehlgeschlagen ist
+    pid_t *batches;         //!< Prozess-IDs der laufenden -exec ... + Kommandos (nur diese setzen failed)
+    size_t batch_count;     //!< Anzahl der laufenden -exec ... + Kommandos
+    size_t batch_capacity;  //!< Größe des batches-Arrays
+} exec_pool_t;
+
+/**
+ * \brief Übersetztes -exec Argument inklusive des Zustands für die Sammel-Ausführung ({} +)
+ */
+typedef struct EXEC {
+    exec_pool_t *pool; //!< gemeinsamer Prozess-Pool der Expression
+    const char **argv; //!< Kommando-Vorlage; bei batch ohne abschließendes {}, NULL-terminiert
+    size_t argc;       //!< Anzahl der Argumente der Vorlage
+    bool batch;        //!< true bei '{} +', false bei ';'
+    bool async;        //!< ';' ohne nachfolgende Parameter: Ergebnis wird nicht benötigt
+    char **paths;      //!< gesammelte Pfade für die nächste Sammel-Ausführung
+    size_t count;      //!< Anzahl der gesammelten Pfade
+    size_t capacity;   //!< Größe des paths-Arrays
+    size_t size;       //!< Bytes die argv (Strings und Pointer) beim Start belegen würde
+    size_t size_max;   //!< maximale Größe von argv laut ARG_MAX abzüglich Environment
+} exec_t;
+
+/**
+ * \brief Eine Datei deren Inhalt im Thread-Pool von -contains durchsucht wird
+ */
+typedef struct CONTENT_JOB {
+    struct CONTENT_JOB *next; //!< nächster Eintrag in der Warteschlange
+    char *file_name;          //!< Pfad der Datei
+    struct stat file_stat;    //!< metadaten der Datei
+    size_t index;             //!< Index des -contains Parameters in der Expression
+    size_t dir;               //!< Index des Verzeichnisses in der -du Tabelle (siehe param_context_t)
+    bool match;               //!< Ergebnis der Suche
+} content_job_t;
+
+/**
+ * \brief Thread-Pool für -contains
+ *
+ * Die Threads lesen und durchsuchen nur Dateien. Die restliche Expression wird für gefundene Dateien
+ * wieder im Haupt-Thread ausgewertet (siehe content_drain()), dadurch müssen Ausgaben und -exec
+ * nicht synchronisiert werden.
+ */
+typedef struct CONTENT_POOL {
+    const struct EXPRESSION *expr; //!< Expression aus der Suchtexte gelesen werden
+    pthread_t *threads;            //!< gestartete Threads
+    size_t thread_count;           //!< Anzahl der gestarteten Threads
+    pthread_mutex_t lock;          //!< schützt alle folgenden Felder
+    pthread_cond_t job_ready;      //!< signalisiert neue Aufträge oder das Beenden
+    pthread_cond_t job_done;       //!< signalisiert einen fertigen Auftrag
+    content_job_t *pending;        //!< Warteschlange der offenen Aufträge (Kopf)
+    content_job_t *pending_tail;   //!< Ende der Warteschlange der offenen Aufträge
+    size_t pending_count;          //!< Anzahl der offenen Aufträge
+    content_job_t *done;           //!< Liste der fertigen Aufträge in Reihenfolge der Fertigstellung (Kopf)
+    content_job_t *done_tail;      //!< Ende der Liste der fertigen Aufträge
+    size_t buffer_size;            //!< Größe des Lese-Buffers den jeder Thread allokiert
+    size_t in_flight;              //!< Anzahl der Aufträge die noch nicht abgeholt wurden
+    bool shutdown;                 //!< true wenn die Threads beendet werden sollen
+} content_pool_t;
+
+/**
+ * \brief Ein Eintrag im devino_set_t
+ */
+typedef struct DEVINO {
+    dev_t dev; //!< Gerät der Datei
+    ino_t ino; //!< Inode-Nummer der Datei
+    bool used; //!< true wenn der Eintrag belegt ist
+} devino_t;
+
+/**
+ * \brief Hash-Set von (st_dev, st_ino) Paaren mit offener Adressierung (lineares Sondieren)
+ *
+ * Wird verwendet um Dateien mit mehreren Hardlinks nur einmal zu verarbeiten.
+ */
+typedef struct DEVINO_SET {
+    devino_t *slots; //!< Tabelle, die Größe ist immer eine Zweierpotenz
+    size_t count;    //!< Anzahl der belegten Einträge
+    size_t capacity; //!< Größe der Tabelle
+} devino_set_t;
+
+/**
+ * \brief Eine von -dupes gesammelte Datei
+ */
+typedef struct DUPE_FILE {
+    char *file_name;  //!< Pfad der Datei
+    int64_t size;     //!< Größe laut stat-Daten
+    uint64_t partial; //!< Hash über Anfang und Ende der Datei, 0 solange nicht berechnet
+    uint64_t full;    //!< Hash über den ganzen Inhalt, 0 solange nicht berechnet
+    bool failed;      //!< true wenn die Datei nicht gelesen werden konnte
+} dupe_file_t;
+
+/**
+ * \brief Zustand eines -dupes Arguments
+ */
+typedef struct DUPES {
+    dupe_file_t *files; //!< gesammelte reguläre Dateien
+    size_t count;       //!< Anzahl der gesammelten Dateien
+    size_t capacity;    //!< Größe des files-Arrays
+    devino_set_t links; //!< bereits gesammelte Dateien mit mehreren Hardlinks
+    bool all_links;     //!< alle Dateien in links merken, da mit -L/-H derselbe Inode mehrfach erreicht werden kann
+} dupes_t;
+
+/**
+ * \brief Die Summen eines Verzeichnisses für -du
+ */
+typedef struct DU_DIR {
+    char *path;     //!< Pfad des Verzeichnisses
+    size_t parent;  //!< Index des übergeordneten Verzeichnisses oder DU_NONE beim Start-Verzeichnis
+    size_t depth;   //!< Tiefe unter dem Start-Verzeichnis, das Start-Verzeichnis hat die Tiefe 0
+    int64_t blocks; //!< belegte 512-Byte Blöcke (st_blocks), nach du_report() inklusive der Unterverzeichnisse
+    uint64_t files; //!< Anzahl der Einträge die keine Verzeichnisse sind, ebenso
+} du_dir_t;
+
+/**
+ * \brief Tabelle der Verzeichnisse einer Traversierung für -du
+ *
+ * Ein übergeordnetes Verzeichnis wird immer vor seinen Unterverzeichnissen eingetragen.
+ */
+typedef struct DU {
+    du_dir_t *dirs;     //!< Verzeichnisse in der Reihenfolge der Traversierung
+    size_t count;       //!< Anzahl der Verzeichnisse
+    size_t capacity;    //!< Größe des dirs-Arrays
+    devino_set_t links; //!< bereits gezählte Dateien mit mehreren Hardlinks
+    bool all_links;     //!< alle Einträge in links merken, da mit -L/-H derselbe Inode mehrfach erreicht werden kann
+} du_t;
+
+/**
+ * \brief Gemeinsame Arbeitsliste der Threads die für -dupes Hashes berechnen
+ */
+typedef struct DUPES_WORK {
+    dupe_file_t *files;   //!< Dateien des -dupes Arguments
+    const size_t *index;  //!< Indizes der zu berechnenden Dateien
+    size_t count;         //!< Anzahl der Indizes
+    size_t next;          //!< nächster noch nicht vergebener Index, durch lock geschützt
+    bool full;            //!< true für den Hash über den ganzen Inhalt, sonst Anfang und Ende
+    pthread_mutex_t lock; //!< schützt next
+} dupes_work_t;
+
+/**
+ * \brief Zustand eines fortlaufend berechneten 64-Bit Hashes (XXH64)
+ */
+typedef struct HASH_STATE {
+    uint64_t v[4];         //!< Akkumulatoren der vier Spuren
+    uint64_t total;        //!< Anzahl der bisher gehashten Bytes
+    unsigned char mem[32]; //!< noch nicht verarbeiteter Rest (weniger als ein Block)
+    size_t mem_size;       //!< Anzahl der Bytes in mem
+} hash_state_t;
+
+/**
+ * \brief Ein Eintrag im name_cache_t
+ */
+typedef struct NAME_ENTRY {
+    unsigned long id; //!< User- bzw. Group-ID
+    char *name;       //!< aufgelöster Name oder NULL wenn es zur ID keinen Eintrag gibt
+    bool used;        //!< true wenn der Eintrag belegt ist
+} name_entry_t;
+
+/**
+ * \brief Zwischenspeicher für die Namen von User- oder Group-IDs (offene Adressierung wie devino_set_t)
+ *
+ * Jede ID wird nur einmal über NSS aufgelöst, auch über mehrere Start-Verzeichnisse hinweg.
+ */
+typedef struct NAME_CACHE {
+    name_entry_t *slots; //!< Tabelle, die Größe ist immer eine Zweierpotenz
+    size_t count;        //!< Anzahl der belegten Einträge
+    size_t capacity;     //!< Größe der Tabelle
+} name_cache_t;
+
+/**
+ * \brief Die Namens-Zwischenspeicher einer Expression, werden nur im Haupt-Thread verwendet
+ */
+typedef struct NAMES {
+    name_cache_t users;  //!< Benutzernamen (getpwuid())
+    name_cache_t groups; //!< Gruppennamen (getgrgid())
+} names_t;
+
+/**
+ * \brief Ein von einem Thread der parallelen Traversierung gelesener Eintrag
+ */
+typedef struct WALK_ENTRY {
+    struct WALK_ENTRY *next;    //!< nächster Eintrag in der Warteschlange
+    char *path;                 //!< Pfad der Datei
+    struct stat stat;           //!< metadaten der Datei
+    size_t depth;               //!< Tiefe unter dem Start-Verzeichnis
+    struct MYFIND_ITER *walker; //!< Iterator des Threads der den Eintrag gelesen hat
+} walk_entry_t;
+
+/**
+ * \brief Parallele Traversierung mehrerer Start-Verzeichnisse (parallel_roots)
+ *
+ * Pro Gerät liest ein Thread mit einem eigenen Iterator die Verzeichnisse seiner Start-Verzeichnisse und legt die
+ * Einträge in eine gemeinsame Warteschlange. Die Expression wird wie bei -contains nur im Haupt-Thread ausgewertet
+ * (siehe walk_next()), dadurch müssen Ausgaben, -exec und die Zwischenspeicher nicht synchronisiert werden.
+ * Die Einträge eines Threads bleiben dabei in der Reihenfolge der Tiefensuche.
+ */
+typedef struct WALK {
+    struct MYFIND_ITER *walkers; //!< Iteratoren der Threads, einer pro Gerät
+    size_t count;                //!< Anzahl der walker
+    pthread_t *threads;          //!< gestartete Threads
+    size_t started;              //!< Anzahl der gestarteten Threads
+    pthread_mutex_t lock;        //!< schützt alle folgenden Felder und das Ergebnis der Iteratoren
+    pthread_cond_t ready;        //!< signalisiert neue Einträge oder das Ende eines Threads
+    pthread_cond_t space;        //!< signalisiert Platz in der Warteschlange oder das Beenden
+    walk_entry_t *head;          //!< Warteschlange der gelesenen Einträge (Kopf)
+    walk_entry_t *tail;          //!< Ende der Warteschlange
+    size_t queued;               //!< Anzahl der Einträge in der Warteschlange
+    size_t active;               //!< Anzahl der Threads die noch lesen
+    bool shutdown;               //!< true wenn die Threads beendet werden sollen
+} walk_t;
+
+/**
+ * \brief Hilfs-Thread der die Verzeichnisse vor der Traversierung liest (prefetch)
+ *
+ * Der Hilfs-Thread durchläuft dieselben Start-Verzeichnisse in derselben Reihenfolge wie die Traversierung,
+ * liest dabei aber nur die Einträge (getdents) und deren Inodes (fstatat()). Damit sind sie bereits im Dentry-
+ * und Inode-Cache des Kernels, wenn die Traversierung nach dem Auswerten der Expression dort ankommt.
+ * Er bleibt höchstens PREFETCH_AHEAD Verzeichnisse vor der Traversierung, damit der Cache nicht mit Verzeichnissen
+ * gefüllt wird die erst viel später gebraucht werden. Die Ergebnisse selbst werden nicht verwendet, Fehler meldet
+ * erst die Traversierung. Symbolischen Links unter den Start-Verzeichnissen wird dabei nicht gefolgt.
+ */
+typedef struct PREFETCH {
+    pthread_t thread;         //!< der Hilfs-Thread
+    char *const *roots;       //!< Start-Verzeichnisse des Iterators
+    size_t root_count;        //!< Anzahl der Start-Verzeichnisse
+    myfind_options_t options; //!< Optionen der Traversierung (Reihenfolge, Links)
+    pthread_mutex_t lock;     //!< schützt alle folgenden Felder
+    pthread_cond_t moved;     //!< signalisiert ein neu geöffnetes Verzeichnis der Traversierung oder das Beenden
+    size_t opened;            //!< Anzahl der von der Traversierung geöffneten Verzeichnisse
+    size_t read;              //!< Anzahl der vom Hilfs-Thread gelesenen Verzeichnisse
+    bool shutdown;            //!< true wenn der Thread beendet werden soll
+} prefetch_t;
+
+/**
+ * \brief Art eines Knotens im Syntaxbaum eines -regex Patterns
+ */
+typedef enum RX_KIND {
+    RX_NODE_BYTES,  //!< ein Byte aus einer Menge (Zeichen, '.', Klammerausdruck)
+    RX_NODE_CAT,    //!< Verkettung der Kinder
+    RX_NODE_ALT,    //!< Alternative der Kinder ('|')
+    RX_NODE_REPEAT, //!< Wiederholung des Kindes ('*', '+', '?', {n,m})
+    RX_NODE_BOL,    //!< Anfang des Pfades ('^')
+    RX_NODE_EOL     //!< Ende des Pfades ('$')
+} rx_kind_t;
+
+/**
+ * \brief Ein Knoten im Syntaxbaum eines -regex Patterns, existiert nur während compile_param_regex()
+ *
+ * Die Kinder von RX_NODE_CAT sind in umgekehrter Reihenfolge verkettet, damit rx_emit() den NFA
+ * ohne Rekursion über die Länge des Patterns von hinten nach vorne aufbauen kann.
+ */
+typedef struct RX_NODE {
+    rx_kind_t kind; //!< Art des Knotens
+    size_t child;   //!< erstes Kind oder RX_NONE
+    size_t sibling; //!< nächstes Kind des Eltern-Knotens oder RX_NONE
+    size_t bytes;   //!< Index der Byte-Menge bei RX_NODE_BYTES
+    int min;        //!< minimale Anzahl bei RX_NODE_REPEAT
+    int max;        //!< maximale Anzahl bei RX_NODE_REPEAT, negativ für unbegrenzt
+    int depth;      //!< Verschachtelungstiefe des Teilbaums, begrenzt die Rekursion von rx_emit()
+} rx_node_t;
+
+/**
+ * \brief Eine Menge von Bytes als Bitmap
+ */
+typedef struct RX_BYTES {
+    uint64_t bits[4]; //!< Bit c gesetzt wenn das Byte c enthalten ist
+} rx_bytes_t;
+
+/**
+ * \brief Art eines NFA-Zustands
+ */
+typedef enum RX_OP {
+    RX_CHAR,  //!< liest ein Byte aus der Menge und geht nach out
+    RX_SPLIT, //!< geht ohne zu lesen nach out und nach alt
+    RX_BOL,   //!< geht ohne zu lesen nach out, aber nur am Anfang des Pfades
+    RX_EOL,   //!< geht ohne zu lesen nach out, aber nur am Ende des Pfades
+    RX_MATCH  //!< Endzustand
+} rx_op_t;
+
+/**
+ * \brief Ein Zustand des NFA (Thompson-Konstruktion)
+ */
+typedef struct RX_STATE {
+    rx_op_t op;    //!< Art des Zustands
+    uint32_t out;  //!< Folgezustand
+    uint32_t alt;  //!< zweiter Folgezustand bei RX_SPLIT
+    uint32_t set;  //!< Index der Byte-Menge bei RX_CHAR
+} rx_state_t;
+
+/**
+ * \brief Ein Zustand des DFA, entspricht einer Menge von NFA-Zuständen
+ *
+ * Die Menge enthält nur die Zustände die ein Byte lesen (RX_CHAR), auf das Ende warten (RX_EOL) oder
+ * den Endzustand. Die Übergänge werden erst bei Bedarf von rx_step() berechnet.
+ */
+typedef struct RX_DFA_STATE {
+    int32_t next[256]; //!< Folgezustand pro Byte, RX_UNKNOWN oder RX_DEAD
+    uint32_t *nfa;     //!< sortierte Menge der NFA-Zustände
+    size_t count;      //!< Anzahl der NFA-Zustände
+    uint64_t hash;     //!< Hash der Menge für rx_add_state()
+    bool start;        //!< true für den Start-Zustand, dort gilt auch '^'
+    bool accept;       //!< true wenn der Pfad in diesem Zustand enden darf
+} rx_dfa_state_t;
+
+/**
+ * \brief Ein übersetztes -regex Pattern
+ *
+ * Das Pattern wird einmalig zu einem NFA übersetzt, der DFA wird daraus während der Traversierung
+ * schrittweise aufgebaut (lazy DFA). Jedes Byte des Pfades kostet danach nur einen Tabellen-Zugriff, ohne
+ * Backtracking. Der DFA wird nur vom Haupt-Thread verwendet und ist auf RX_DFA_MAX Zustände begrenzt,
+ * danach wird er verworfen und neu aufgebaut.
+ */
+typedef struct RX {
+    rx_state_t *nfa;     //!< Zustände des NFA, 0 ist der Endzustand
+    size_t nfa_count;    //!< Anzahl der NFA-Zustände
+    size_t nfa_capacity; //!< Größe von nfa
+    uint32_t root;       //!< Start-Zustand des NFA
+    rx_bytes_t *sets;    //!< Byte-Mengen der RX_CHAR Zustände
+    size_t set_count;    //!< Anzahl der Byte-Mengen
+    size_t set_capacity; //!< Größe von sets
+    rx_dfa_state_t *dfa; //!< bisher berechnete DFA-Zustände
+    size_t dfa_count;    //!< Anzahl der DFA-Zustände
+    size_t dfa_capacity; //!< Größe von dfa
+    int32_t *table;      //!< Hash-Tabelle der DFA-Zustände (2 * RX_DFA_MAX Einträge, -1 für frei)
+    int32_t start;       //!< Start-Zustand des DFA oder RX_UNKNOWN
+    size_t flushes;      //!< Anzahl der verworfenen DFA-Caches
+    uint32_t *mark;      //!< Generation in der ein NFA-Zustand zuletzt besucht wurde (rx_closure())
+    uint32_t generation; //!< aktuelle Generation für mark
+    uint32_t *stack;     //!< Stack für rx_closure()
+    uint32_t *work;      //!< Menge des nächsten DFA-Zustands
+    uint32_t *scratch;   //!< Menge für die Berechnung von accept
+} rx_t;
+
+/**
+ * \brief Zustand des Parsers von compile_param_regex()
+ */
+typedef struct RX_PARSER {
+    const char *pos;   //!< nächstes Zeichen des Patterns
+    bool icase;        //!< Groß- und Kleinschreibung nicht unterscheiden (-iregex)
+    int depth;         //!< aktuelle Verschachtelung von Gruppen
+    rx_node_t *nodes;  //!< Knoten des Syntaxbaums
+    size_t count;      //!< Anzahl der Knoten
+    size_t capacity;   //!< Größe von nodes
+    rx_t *rx;          //!< das entstehende Pattern (Byte-Mengen)
+} rx_parser_t;
+
+/**
+ * \brief wird für die parameter-prüfung verwendet
+ *
+ * Die Felder nach value werden von compile_param() einmalig vorberechnet, damit die Prüfung pro Datei
+ * nur noch einen Vergleich auf den bereits gelesenen stat-Daten benötigt.
+ */
+typedef struct PARAM {
+    opt_t opt;      //!< gefundene Option oder invalid-flag
+    char *value;    //!< Erweiterte Benutzereingabe bei dynamischen Argumenten (z.B. -name <pattern>)
+    uid_t uid;      //!< aufgelöster Benutzer bei -user
+    int64_t min;    //!< untere Grenze (inklusive) bei -size, -mtime, -mmin und -newer
+    int64_t max;    //!< obere Grenze (inklusive) bei -size, -mtime, -mmin und -newer
+    exec_t *exec;   //!< übersetztes Kommando bei -exec
+    dupes_t *dupes; //!< gesammelte Dateien bei -dupes
+    du_t *du;       //!< Verzeichnis-Tabelle bei -du, gehört der Expression
+    names_t *names; //!< Namens-Zwischenspeicher bei -ls und -nouser, gehört der Expression
+    rx_t *regex;    //!< übersetztes Pattern bei -regex und -iregex
+    int64_t *hits;  //!< Anzahl der Dateien die -limit in dieser Traversierung erreicht haben (Limit in min)
+} param_t;
+
+/**
+ * \brief Token-Bucket für --max-rate bzw. --max-dir-rate
+ *
+ * Pro Sekunde kommen rate Tokens dazu, höchstens burst Tokens werden angespart. Jeder Eintrag bzw. jedes
+ * Verzeichnis nimmt ein Token. Fehlt es, wird es trotzdem genommen (tokens wird negativ) und der Thread wartet
+ * bis es nachgefüllt wäre. Dadurch reihen sich die walker der parallelen Traversierung fair ein.
+ */
+typedef struct BUCKET {
+    double rate;    //!< Tokens pro Sekunde, 0 für unbegrenzt
+    double burst;   //!< maximal angesparte Tokens
+    double tokens;  //!< verfügbare Tokens, negativ wenn bereits auf Nachschub gewartet wird
+    int64_t filled; //!< Zeitpunkt der letzten Nachfüllung in Nanosekunden
+} bucket_t;
+
+/**
+ * \brief Begrenzung der Traversierung und Statistik (--max-rate, --max-dir-rate, --backoff-latency, --stats)
+ *
+ * Wird von allen walkern der parallelen Traversierung gemeinsam verwendet, die Zeiten sind CLOCK_MONOTONIC.
+ * Steigt die Lesezeit eines Verzeichnisses über latency_max, wird vor jedem weiteren Verzeichnis delay gewartet.
+ * delay verdoppelt sich bei jedem langsamen Verzeichnis und sinkt bei jedem schnellen um ein Achtel, so weicht
+ * die Traversierung bei Last sofort aus und kehrt nur langsam zum vollen Tempo zurück.
+ */
+typedef struct THROTTLE {
+    pthread_mutex_t lock;  //!< schützt alle folgenden Felder
+    bool enabled;          //!< true wenn eine Begrenzung oder --stats gesetzt ist, sonst wird nichts gezählt
+    bucket_t entries;      //!< Token-Bucket für Einträge (--max-rate)
+    bucket_t dirs;         //!< Token-Bucket für gelesene Verzeichnisse (--max-dir-rate)
+    int64_t latency_max;   //!< Lesezeit eines Verzeichnisses ab der ausgewichen wird, 0 wenn aus
+    int64_t delay;         //!< aktuelle Pause vor jedem Verzeichnis in Nanosekunden
+    int64_t started;       //!< Beginn der Traversierung
+    uint64_t entry_count;  //!< verarbeitete Einträge
+    uint64_t dir_count;    //!< gelesene Verzeichnisse
+    uint64_t slow_count;   //!< Verzeichnisse deren Lesezeit über latency_max lag
+    int64_t read_time;     //!< gesamte Lesezeit der Verzeichnisse
+    int64_t rate_wait;     //!< gesamte Wartezeit in den Token-Buckets
+    int64_t backoff_wait;  //!< gesamte Wartezeit durch das Ausweichen
+    int64_t delay_max;     //!< größte Pause durch das Ausweichen
+} throttle_t;
+
+/**
+ * \brief Die übersetzte Expression, wird von compile_params() erstellt
+ */
+typedef struct EXPRESSION {
+    param_t *params; //!< Array der übersetzten Parameter in Eingabe-Reihenfolge
+    size_t count;    //!< Anzahl der Parameter
+    bool has_action; //!< true wenn eine Ausgabe-Option (-print, -ls) vorkommt, sonst wird implizit -print verwendet
+    int64_t now;     //!< Startzeitpunkt in Nanosekunden, Referenz für -mtime und -mmin
+    exec_pool_t pool; //!< Prozess-Pool für alle -exec Argumente
+    myfind_options_t options; //!< Optionen der Traversierung
+    char *content_buffer;     //!< Lese-Buffer für -contains im Haupt-Thread
+    content_pool_t *content;  //!< Thread-Pool für -contains oder NULL wenn im Haupt-Thread gesucht wird
+    struct MYFIND_ITER *iter; //!< Iterator der die Treffer abholt, NULL wenn keine Traversierung läuft
+    du_t *du;                 //!< Verzeichnis-Tabelle aller -du Argumente oder NULL wenn -du nicht vorkommt
+    names_t names;            //!< aufgelöste Benutzer- und Gruppennamen für alle Traversierungen
+    throttle_t throttle;      //!< Begrenzung und Statistik der laufenden Traversierung
+} expression_t;
+
+/**
+ * \brief Zustand einer Traversierung, wird von myfind_iter_open_roots() erstellt
+ *
+ * Jeder Schritt (do_next()) verarbeitet genau einen Verzeichniseintrag. Die dabei gefundenen Treffer werden
+ * in matches gesammelt und von myfind_iter_next() einzeln abgegeben.
+ *
+ * Die Threads der parallelen Traversierung verwenden ebenfalls je einen Iterator (walker), dieser wertet
+ * die Expression aber nicht aus, sondern übergibt die Einträge mit walk_submit() an den Haupt-Thread.
+ */
+struct MYFIND_ITER {
+    expression_t *expr;     //!< übersetzte Expression
+    char **roots;           //!< Start-Verzeichnisse, bei einem walker nur geliehen
+    size_t root_count;      //!< Anzahl der Start-Verzeichnisse
+    size_t root_next;       //!< Index des nächsten Start-Verzeichnisses
+    frame_t *frames;        //!< Stack der offenen Verzeichnisse
+    size_t depth;           //!< Anzahl der Verzeichnisse auf dem Stack
+    size_t capacity;        //!< Größe des frames-Arrays
+    devino_set_t ancestors; //!< (st_dev, st_ino) aller Verzeichnisse auf dem Stack, nur beim Folgen von Links
+    match_t *matches;       //!< gesammelte Treffer
+    size_t match_count;     //!< Anzahl der gesammelten Treffer
+    size_t match_next;      //!< Index des nächsten abzugebenden Treffers
+    size_t match_capacity;  //!< Größe des matches-Arrays
+    match_t current;        //!< zuletzt abgegebener Treffer, gültig bis zum nächsten Aufruf
+    bool finished;          //!< true sobald die Expression mit finish_params() abgeschlossen wurde
+    retval_t result;        //!< Ergebnis der Traversierung
+    walk_t *walk;           //!< parallele Traversierung oder NULL
+    bool walker;            //!< true wenn der Iterator in einem Thread von walk läuft
+    size_t *du_dirs;        //!< walker: -du Index des zuletzt gelesenen Verzeichnisses pro Tiefe (Haupt-Thread)
+    size_t du_depth;        //!< walker: Größe des du_dirs-Arrays
+    prefetch_t *prefetch;   //!< Hilfs-Thread zum Vorauslesen oder NULL
+    bool quit;              //!< true nach -quit oder erreichtem -limit, die Traversierung endet mit diesem Eintrag
+    int64_t checkpoint_at;  //!< Zeitpunkt des nächsten Checkpoints (CLOCK_MONOTONIC in Nanosekunden)
+};
+
+// -------------------------------------------------------------- prototypes --
+static retval_t do_next(myfind_iter_t *iter);
+static retval_t do_file(myfind_iter_t *iter, const char *file_name);
+static retval_t do_entry(myfind_iter_t *iter, const char *file_name, struct stat *file_stat);
+static retval_t do_dir(myfind_iter_t *iter, const param_context_t *paramc);
+static bool is_loop(myfind_iter_t *iter, const char *dir_name, const struct stat *dir_stat);
+static int stat_entry(const char *file_name, struct stat *file_stat, bool follow);
+static retval_t do_dir_sorted(myfind_iter_t *iter, frame_t *frame, DIR *dirp);
+static retval_t push_frame(myfind_iter_t *iter, const char *dir_name, const struct stat *dir_stat, frame_t **frame);
+static void pop_frame(myfind_iter_t *iter);
+static void finish_iter(myfind_iter_t *iter);
+static retval_t walk_start(myfind_iter_t *iter);
+static retval_t walk_submit(myfind_iter_t *iter, const char *file_name, const struct stat *file_stat);
+static retval_t walk_next(myfind_iter_t *iter);
+static void *walk_worker(void *arg);
+static void walk_stop(myfind_iter_t *iter);
+static retval_t prefetch_start(myfind_iter_t *iter);
+static void prefetch_opened(prefetch_t *prefetch);
+static void *prefetch_worker(void *arg);
+static bool prefetch_dir(prefetch_t *prefetch, const char *dir_name);
+static void prefetch_stop(myfind_iter_t *iter);
+static void throttle_start(throttle_t *throttle, const myfind_options_t *options);
+static void throttle_entry(throttle_t *throttle);
+static int64_t throttle_dir(throttle_t *throttle);
+static void throttle_dir_done(throttle_t *throttle, int64_t latency);
+static int64_t bucket_take(bucket_t *bucket);
+static int64_t throttle_clock(const throttle_t *throttle);
+static void throttle_sleep(int64_t ns);
+static void throttle_report(throttle_t *throttle);
+static bool checkpoint_supported(const expression_t *expr);
+static retval_t checkpoint_update(myfind_iter_t *iter);
+static bool checkpoint_write(const myfind_iter_t *iter, const myfind_position_t *position);
+static retval_t checkpoint_read(myfind_iter_t *iter, const char *file_name);
+static retval_t checkpoint_resume(myfind_iter_t *iter, FILE *fp, myfind_position_t *position);
+static retval_t checkpoint_resume_frame(myfind_iter_t *iter, const char *path, const char *last, bool *lost);
+static void checkpoint_put(FILE *fp, const char *string);
+static char *checkpoint_get(FILE *fp);
+static retval_t emit_match(const param_context_t *paramc, myfind_iter_t *iter);
+static retval_t read_dir_entries(const char *dir_name, DIR *dirp, dir_entry_t **entries, size_t *count);
+static void stat_dir_entries(const char *dir_name, dir_entry_t *entries, size_t count, bool follow);
+static void free_dir_entries(dir_entry_t *entries, size_t count);
+static int compare_entry_ino(const void *a, const void *b);
+static int compare_entry_name(const void *a, const void *b);
+
+static retval_t compile_params(const char *const *parms, expression_t *expr);
+static retval_t compile_param(param_t *param, const expression_t *expr);
+static retval_t compile_param_user(param_t *param);
+static retval_t compile_param_type(const param_t *param);
+static retval_t compile_param_size(param_t *param);
+static retval_t compile_param_time(param_t *param, int64_t now, int64_t period, bool round_up);
+static retval_t compile_param_newer(param_t *param, follow_t follow);
+static retval_t compile_param_exec(param_t *param, const char *const *parms, int *i, exec_pool_t *pool);
+static retval_t compile_param_du(param_t *param, expression_t *expr);
+static retval_t compile_param_regex(param_t *param, bool icase);
+static retval_t compile_param_limit(param_t *param);
+static retval_t parse_number(const char *value, char *cmp, int64_t *num, const char **suffix);
+static retval_t parse_unit(const char *suffix, int64_t default_unit, int64_t *unit);
+static void reorder_params(expression_t *expr);
+static bool is_predicate(opt_t opt);
+static retval_t finish_params(expression_t *expr);
+static void free_params(expression_t *expr);
+
+static retval_t do_params(const param_context_t *paramc, const expression_t *expr);
+static retval_t eval_params(const param_context_t *paramc, const expression_t *expr, size_t start);
+static retval_t get_param(const char *command, const char *next_param, param_t *param);
+static retval_t strtoopt(const char *command, opt_t *opt);
+static retval_t check_value(opt_t opt, const char *next_parm);
+static retval_t handle_param(const param_t *param, const param_context_t *paramc);
+
+static retval_t do_param_print(const param_context_t *paramc);
+static retval_t do_param_quit(const param_t *param, myfind_iter_t *iter);
+
+static retval_t do_param_list(const param_t *param, const param_context_t *paramc);
+static char get_file_type(int mode);
+static size_t snprintf_permissions(char *buf, size_t bufsize, int mode);
+static size_t snprintf_username(name_cache_t *users, char *buf, size_t bufsize, uid_t uid);
+static size_t snprintf_groupname(name_cache_t *groups, char *buf, size_t bufsize, gid_t gid);
+static size_t snprintf_filetime(char *buf, size_t bufsize, const time_t *time);
+static const char *name_lookup(name_cache_t *cache, unsigned long id, bool group);
+static void name_cache_free(name_cache_t *cache);
+
+static retval_t do_param_nouser(const param_t *param, const param_context_t *paramc);
+static retval_t do_param_user(const param_t *param, const param_context_t *paramc);
+static retval_t do_param_type(const param_t *param, const param_context_t *paramc);
+static retval_t do_param_name(const param_t *param, const param_context_t *paramc);
+static retval_t do_param_path(const param_t *param, const param_context_t *paramc);
+static retval_t do_param_regex(const param_t *param, const param_context_t *paramc);
+static retval_t rx_parse_alt(rx_parser_t *parser, size_t *node);
+static retval_t rx_parse_branch(rx_parser_t *parser, size_t *node);
+static retval_t rx_parse_piece(rx_parser_t *parser, size_t *node);
+static retval_t rx_parse_atom(rx_parser_t *parser, size_t *node);
+static retval_t rx_parse_bracket(rx_parser_t *parser, rx_bytes_t *bytes);
+static retval_t rx_parse_interval(rx_parser_t *parser, int *min, int *max);
+static retval_t rx_new_node(rx_parser_t *parser, rx_kind_t kind, size_t child, size_t *node);
+static retval_t rx_add_child(rx_parser_t *parser, size_t node, size_t child);
+static retval_t rx_new_bytes(rx_parser_t *parser, const rx_bytes_t *bytes, size_t *node);
+static void rx_fold(rx_bytes_t *bytes);
+static retval_t rx_emit(rx_t *rx, const rx_node_t *nodes, size_t node, uint32_t next, uint32_t *start);
+static retval_t rx_new_state(rx_t *rx, rx_op_t op, uint32_t out, uint32_t alt, uint32_t *state);
+static retval_t rx_match(rx_t *rx, const char *text, bool *match);
+static retval_t rx_step(rx_t *rx, int32_t from, unsigned char c, int32_t *next);
+static retval_t rx_add_state(rx_t *rx, size_t count, bool start, int32_t *state);
+static void rx_closure(rx_t *rx, uint32_t state, bool at_start, bool at_end, uint32_t *set, size_t *count);
+static void rx_next_generation(rx_t *rx);
+static void rx_flush(rx_t *rx);
+static int compare_rx_state(const void *a, const void *b);
+static void rx_free(rx_t *rx);
+static retval_t do_param_range(const param_t *param, int64_t key);
+static retval_t do_param_exec(const param_t *param, const param_context_t *paramc);
+static retval_t exec_flush(exec_t *exec);
+static retval_t exec_spawn(exec_pool_t *pool, char *const argv[], bool async, bool batch);
+static void exec_wait(exec_pool_t *pool, unsigned long max_running);
+static char *exec_replace(const char *arg, const char *file_name);
+static retval_t do_param_contains(const param_t *param, const param_context_t *paramc, char *buf);
+static bool search_file(const char *file_name, const char *needle, size_t needle_len, char *buf);
+static const char *search_substring(const char *haystack, size_t haystack_len, const char *needle,
+                                    size_t needle_len);
+static retval_t content_start(expression_t *expr, unsigned long threads);
+static retval_t content_submit(content_pool_t *pool, const param_context_t *paramc, size_t index);
+static retval_t content_drain(content_pool_t *pool, bool wait_all);
+static void *content_worker(void *arg);
+static void content_stop(content_pool_t *pool);
+static retval_t do_param_dupes(const param_t *param, const param_context_t *paramc);
+static retval_t dupes_report(dupes_t *dupes, unsigned long threads);
+static void dupes_hash(dupe_file_t *files, const size_t *index, size_t count, bool full, unsigned long threads);
+static void *dupes_worker(void *arg);
+static void dupes_hash_file(dupe_file_t *file, bool full, char *buf);
+static bool dupes_equal(const dupe_file_t *a, const dupe_file_t *b);
+static int compare_dupe(const void *a, const void *b);
+static void clear_dupes(dupes_t *dupes);
+static void free_dupes(dupes_t *dupes);
+static retval_t do_param_du(const param_t *param, const param_context_t *paramc);
+static retval_t du_enter(du_t *du, param_context_t *paramc, size_t depth, size_t parent);
+static retval_t du_add_dir(du_t *du, const char *path, size_t parent, size_t depth, size_t *index);
+static retval_t du_report(du_t *du, long max_depth);
+static int compare_du_dir(const void *a, const void *b);
+static void clear_du(du_t *du);
+static void free_du(du_t *du);
+static retval_t devino_insert(devino_set_t *set, dev_t dev, ino_t ino);
+static bool devino_contains(const devino_set_t *set, dev_t dev, ino_t ino);
+static void devino_remove(devino_set_t *set, dev_t dev, ino_t ino);
+static uint64_t devino_hash(dev_t dev, ino_t ino);
+static void devino_free(devino_set_t *set);
+static void hash_init(hash_state_t *state);
+static void hash_update(hash_state_t *state, const void *data, size_t len);
+static uint64_t hash_digest(const hash_state_t *state);
+
+static void handle_error(const param_t *param, int result);
+
+// -------------------------------------------------------------- constants --
+/**
+ * \brief wird verwendet um die Benutzereingaben zu validieren. Index entspricht Wert des OPTs
+ *
+ */
+static const char *const OPT_NAME[] = {"",       "-print", "-ls",   "-user", "-name", "-type",
+                                       "-nouser", "-path",  "-size", "-mtime", "-mmin", "-newer", "-exec", "-contains",
+                                       "-dupes", "-du",    "-regex", "-iregex", "-quit",
+                                       "-limit"};
+
+extern char **environ;
+
+// -------------------------------------------------------------- functions --
+
+/**
+ * \brief Setzt alle Optionen auf ihre Standardwerte
+ *
+ * Die Standardwerte sind: jobs 1, du_depth -1 (alle Tiefen), follow FOLLOW_NEVER und
+ * alle anderen Felder false, 0 bzw. NULL.
+ *
+ * \param options die zu initialisierenden Optionen
+ */
+void myfind_options_init(myfind_options_t *options) {
+    *options = (myfind_options_t){
+        .jobs = 1,
+        .follow = FOLLOW_NEVER,
+        .du_depth = -1,
+    };
+}
+
+/**
+ * \brief Übersetzt die Expression-Argumente und bereitet die Expression für Traversierungen vor.
+ *
+ * \param args die Expression-Argumente (NULL-terminiert)
+ * \param options Optionen der Traversierung oder NULL für die Standardwerte
+ * \param expr Ausgabe-Pointer für die übersetzte Expression. Muss mit myfind_free() freigegeben werden.
+ *
+ * \func compile_params() übersetzt die Argumente, Fehler werden dabei bereits ausgegeben.
+ * \func content_start() startet bei Bedarf den Thread-Pool von -contains.
+ *
+ * \return OK_NOERROR wenn erfolgreich oder einen negativen Error-Code im Fehlerfall
+ */
+retval_t myfind_compile(const char *const *args, const myfind_options_t *options, myfind_expr_t **expr) {
+    retval_t result;
+
+    *expr = NULL;
+    expression_t *e = calloc(1, sizeof(expression_t));
+    if (e == NULL)
+        return ERR_OUT_OF_MEMORY;
+
+    if (options != NULL)
+        e->options = *options;
+    else
+        myfind_options_init(&e->options);
+    pthread_mutex_init(&e->throttle.lock, NULL);
+    if (e->options.jobs == 0)
+        e->options.jobs = 1;
+    e->pool.max_jobs = e->options.jobs;
+    // the position within a directory is stored as the name of the last processed entry
+    if (e->options.checkpoint != NULL || e->options.resume != NULL)
+        e->options.sort_name = true;
+
+    result = compile_params(args, e);
+    if (result == OK_NOERROR && (e->options.checkpoint != NULL || e->options.resume != NULL) &&
+        !checkpoint_supported(e)) {
+        error(ERR_NONCRITICAL, 0,
+              "--checkpoint and --resume can't be combined with -du, -dupes, --parallel-roots or --prefetch");
+        result = ERR_INVALID_ARGUMENT;
+    }
+    if (result == OK_NOERROR)
+        result = content_start(e, e->options.jobs);
+
+    if (result != OK_NOERROR) {
+        myfind_free(e);
+        return result;
+    }
+
+    *expr = e;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Gibt eine von myfind_compile() übersetzte Expression frei.
+ *
+ * \param expr freizugebende Expression (kann NULL sein)
+ */
+void myfind_free(myfind_expr_t *expr) {
+    if (expr == NULL)
+        return;
+
+    free_params(expr);
+    free(expr->pool.batches);
+    pthread_mutex_destroy(&expr->throttle.lock);
+    free(expr);
+}
+
+/**
+ * \brief Durchsucht ein Start-Verzeichnis und ruft für jeden Treffer einen Callback auf.
+ *
+ * \param expr die übersetzte Expression
+ * \param root Start-Verzeichnis
+ * \param callback wird für jeden Treffer aufgerufen
+ * \param data wird unverändert an den Callback übergeben
+ *
+ * \return siehe myfind_run_roots()
+ */
+retval_t myfind_run(myfind_expr_t *expr, const char *root, myfind_callback_t callback, void *data) {
+    return myfind_run_roots(expr, &root, 1, callback, data);
+}
+
+/**
+ * \brief Durchsucht mehrere Start-Verzeichnisse und ruft für jeden Treffer einen Callback auf.
+ *
+ * Der Callback wird immer im aufrufenden Thread aufgerufen, auch wenn -contains oder parallel_roots
+ * Threads verwendet.
+ *
+ * \param expr die übersetzte Expression
+ * \param roots Start-Verzeichnisse
+ * \param count Anzahl der Start-Verzeichnisse
+ * \param callback wird für jeden Treffer aufgerufen
+ * \param data wird unverändert an den Callback übergeben
+ *
+ * \func myfind_iter_open_roots() startet die Traversierung
+ * \func myfind_iter_next() liefert den nächsten Treffer
+ * \func myfind_iter_close() schließt die Traversierung ab
+ *
+ * \return OK_NOERROR, den Fehler der Traversierung oder den negativen Rückgabewert des Callbacks
+ */
+retval_t myfind_run_roots(myfind_expr_t *expr, const char *const *roots, size_t count, myfind_callback_t callback,
+                          void *data) {
+    myfind_iter_t *iter;
+    const char *path;
+    const struct stat *file_stat;
+    int stop = 0;
+
+    retval_t result = myfind_iter_open_roots(expr, roots, count, &iter);
+    if (result != OK_NOERROR)
+        return result;
+
+    while (stop == 0 && myfind_iter_next(iter, &path, &file_stat) == OK_PROCEED)
+        stop = callback(path, file_stat, data);
+
+    // run pending -exec batches and wait for all commands, even on errors
+    result = myfind_iter_close(iter);
+    return (stop < 0) ? (retval_t)stop : result;
+}
+
+/**
+ * \brief Startet eine Traversierung eines Start-Verzeichnisses, siehe myfind_iter_open_roots().
+ *
+ * \param expr die übersetzte Expression
+ * \param root Start-Verzeichnis
+ * \param iter Ausgabe-Pointer für den Iterator. Muss mit myfind_iter_close() geschlossen werden.
+ *
+ * \return siehe myfind_iter_open_roots()
+ */
+retval_t myfind_iter_open(myfind_expr_t *expr, const char *root, myfind_iter_t **iter) {
+    return myfind_iter_open_roots(expr, &root, 1, iter);
+}
+
+/**
+ * \brief Startet eine Traversierung, deren Treffer mit myfind_iter_next() abgeholt werden.
+ *
+ * Die Start-Verzeichnisse werden in der angegebenen Reihenfolge durchsucht. Mit parallel_roots werden sie
+ * nach Gerät gruppiert und die Gruppen gleichzeitig gelesen, die Treffer verschiedener Geräte sind dann gemischt.
+ * Pro Expression kann immer nur eine Traversierung gleichzeitig laufen.
+ *
+ * \param expr die übersetzte Expression
+ * \param roots Start-Verzeichnisse
+ * \param count Anzahl der Start-Verzeichnisse
+ * \param iter Ausgabe-Pointer für den Iterator. Muss mit myfind_iter_close() geschlossen werden.
+ *
+ * \func walk_start() startet bei Bedarf die Threads der parallelen Traversierung
+ * \func prefetch_start() startet bei Bedarf den Hilfs-Thread zum Vorauslesen, bei paralleler Traversierung
+ *      startet jeder walker seinen eigenen (siehe walk_worker())
+ * \func checkpoint_read() setzt die Traversierung mit resume an der Position des Checkpoints fort
+ *
+ * \return OK_NOERROR, ERR_INVALID_ARGUMENT wenn bereits eine Traversierung läuft oder der Checkpoint ungültig ist
+ *         oder ERR_OUT_OF_MEMORY
+ */
+retval_t myfind_iter_open_roots(myfind_expr_t *expr, const char *const *roots, size_t count, myfind_iter_t **iter) {
+    *iter = NULL;
+    if (expr->iter != NULL)
+        return ERR_INVALID_ARGUMENT;
+
+    myfind_iter_t *it = calloc(1, sizeof(myfind_iter_t));
+    if (it == NULL || (it->roots = calloc(count + 1, sizeof(char *))) == NULL) {
+        free(it);
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    it->expr = expr;
+    it->result = OK_NOERROR;
+    throttle_start(&expr->throttle, &expr->options);
+    for (; it->root_count < count; it->root_count++) {
+        if ((it->roots[it->root_count] = strdup(roots[it->root_count])) == NULL) {
+            it->result = ERR_OUT_OF_MEMORY;
+            break;
+        }
+    }
+
+    if (it->result == OK_NOERROR && expr->options.parallel_roots && count > 1)
+        it->result = walk_start(it);
+    // with parallel_roots every walker reads ahead for itself
+    if (it->result == OK_NOERROR && expr->options.prefetch && it->walk == NULL)
+        it->result = prefetch_start(it);
+    if (it->result == OK_NOERROR && expr->options.resume != NULL)
+        it->result = checkpoint_read(it, expr->options.resume);
+
+    if (it->result != OK_NOERROR) {
+        retval_t result = it->result;
+        while (it->depth > 0)
+            pop_frame(it);
+        prefetch_stop(it);
+        free(it->frames);
+        devino_free(&it->ancestors);
+        for (size_t i = 0; i < it->root_count; i++)
+            free(it->roots[i]);
+        free(it->roots);
+        free(it);
+        return result;
+    }
+
+    if (expr->options.checkpoint != NULL) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        it->checkpoint_at = timespec_to_ns(&now) + CHECKPOINT_INTERVAL * NSEC_PER_SEC;
+    }
+
+    expr->iter = it;
+    *iter = it;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Liefert den nächsten Treffer einer Traversierung.
+ *
+ * Die Traversierung wird nur so weit fortgesetzt, bis ein Treffer gefunden wurde. Ist sie zu Ende,
+ * wird die Expression abgeschlossen (siehe finish_params()), dabei können noch weitere Treffer entstehen.
+ *
+ * \param iter der Iterator
+ * \param path Ausgabe-Pointer für den Pfad, gültig bis zum nächsten Aufruf
+ * \param file_stat Ausgabe-Pointer für die stat-Daten, gültig bis zum nächsten Aufruf
+ *
+ * \func do_next() verarbeitet den nächsten Verzeichniseintrag
+ * \func checkpoint_update() schreibt mit --checkpoint regelmäßig die Position der Traversierung
+ *
+ * \return OK_PROCEED wenn ein Treffer geliefert wurde, OK_STOP am Ende der Traversierung
+ *         oder einen negativen Error-Code wenn die Traversierung abgebrochen wurde
+ */
+retval_t myfind_iter_next(myfind_iter_t *iter, const char **path, const struct stat **file_stat) {
+    free(iter->current.path);
+    iter->current.path = NULL;
+
+    while (iter->match_next == iter->match_count) {
+        if (iter->finished)
+            return (iter->result < 0) ? iter->result : OK_STOP;
+
+        iter->match_next = 0;
+        iter->match_count = 0;
+
+        // only between two entries all output up to the current position is complete
+        retval_t result = (iter->expr->options.checkpoint != NULL) ? checkpoint_update(iter) : OK_NOERROR;
+        if (result == OK_NOERROR && !iter->quit)
+            result = do_next(iter);
+        if (result < 0)
+            iter->result = result;
+        // -quit and -limit end the traversal early, the matches of this entry are still delivered
+        if ((result != OK_NOERROR && result != OK_DEFERRED) || iter->quit)
+            finish_iter(iter);
+    }
+
+    // the path is moved out of the queue and freed with the next call
+    iter->current = iter->matches[iter->match_next++];
+    *path = iter->current.path;
+    *file_stat = &iter->current.stat;
+    return OK_PROCEED;
+}
+
+/**
+ * \brief Schließt eine Traversierung ab und gibt den Iterator frei.
+ *
+ * Wurde die Traversierung vorzeitig beendet, wird die Expression trotzdem abgeschlossen, damit gesammelte
+ * -exec Pfade ausgeführt und alle Kommandos abgewartet werden.
+ *
+ * \param iter der Iterator (kann NULL sein)
+ *
+ * \return das Ergebnis der Traversierung, siehe myfind_iter_next()
+ */
+retval_t myfind_iter_close(myfind_iter_t *iter) {
+    if (iter == NULL)
+        return OK_NOERROR;
+
+    if (!iter->finished)
+        finish_iter(iter);
+
+    retval_t result = iter->result;
+
+    for (size_t i = iter->match_next; i < iter->match_count; i++)
+        free(iter->matches[i].path);
+    free(iter->matches);
+    free(iter->current.path);
+    free(iter->frames);
+    devino_free(&iter->ancestors);
+    for (size_t i = 0; i < iter->root_count; i++)
+        free(iter->roots[i]);
+    free(iter->roots);
+
+    iter->expr->iter = NULL;
+    free(iter);
+    return result;
+}
+
+/**
+ * \brief Liest eine Größenangabe wie bei --max-content-size ("n" mit optionaler Einheit [bcwkMG], Standard Byte).
+ *
+ * \param value zu lesende Zeichenkette
+ * \param size Ausgabe-Pointer für die Größe in Bytes
+ *
+ * \return OK_NOERROR oder ERR_INVALID_NUMBER
+ */
+retval_t myfind_parse_size(const char *value, int64_t *size) {
+    char cmp;
+    const char *suffix;
+    int64_t unit;
+
+    if (parse_number(value, &cmp, size, &suffix) != OK_NOERROR || cmp != '=' ||
+        parse_unit(suffix, 1, &unit) != OK_NOERROR || *size > INT64_MAX / unit)
+        return ERR_INVALID_NUMBER;
+
+    *size *= unit;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Schließt die Traversierung eines Iterators ab.
+ *
+ * Alle noch offenen Verzeichnisse werden geschlossen bzw. die Threads der parallelen Traversierung beendet
+ * und die Expression mit finish_params() abgeschlossen. Ein Checkpoint wird nach erfolgreichem Ende gelöscht,
+ * nach einem Fehler bleibt er für --resume erhalten.
+ *
+ * \param iter der Iterator
+ */
+static void finish_iter(myfind_iter_t *iter) {
+    while (iter->depth > 0)
+        pop_frame(iter);
+    walk_stop(iter);
+    prefetch_stop(iter);
+
+    retval_t result = finish_params(iter->expr);
+    if (iter->result == OK_NOERROR)
+        iter->result = result;
+    iter->finished = true;
+    if (iter->expr->options.stats)
+        throttle_report(&iter->expr->throttle);
+
+    const char *checkpoint = iter->expr->options.checkpoint;
+    if (checkpoint != NULL && iter->result == OK_NOERROR && unlink(checkpoint) == -1) {
+        if (errno != ENOENT)
+            error(ERR_NONCRITICAL, errno, "can't remove checkpoint '%s'", checkpoint);
+        errno = 0;
+    }
+
+    debug_print("DEBUG: Finished traversal of %lu roots with '%d'\n", (unsigned long)iter->root_count, iter->result);
+}
+
+/**
+ * \brief Startet die parallele Traversierung der Start-Verzeichnisse.
+ *
+ * Die Start-Verzeichnisse werden nach st_dev gruppiert, jede Gruppe wird von einem eigenen Thread der Reihe nach
+ * gelesen. Start-Verzeichnisse auf demselben Gerät werden so nicht gleichzeitig gelesen, da sich die Threads
+ * dort nur gegenseitig die Kopfbewegungen bzw. die Warteschlange des Geräts streitig machen würden.
+ * Liegen alle Start-Verzeichnisse auf einem Gerät, wird keine parallele Traversierung gestartet.
+ *
+ * \param iter der Iterator des Haupt-Threads
+ *
+ * \func stat_entry() liest das Gerät der Start-Verzeichnisse, Fehler werden erst vom Thread gemeldet
+ * \func pthread_create() startet die Threads mit walk_worker()
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t walk_start(myfind_iter_t *iter) {
+    size_t count = iter->root_count;
+    size_t groups = 0;
+    struct stat st;
+
+    dev_t *devs = malloc(count * sizeof(dev_t));
+    size_t *group = malloc(count * sizeof(size_t));
+    walk_t *walk = calloc(1, sizeof(walk_t));
+    if (devs == NULL || group == NULL || walk == NULL) {
+        free(devs);
+        free(group);
+        free(walk);
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        dev_t dev = (stat_entry(iter->roots[i], &st, iter->expr->options.follow != FOLLOW_NEVER) == 0) ? st.st_dev : 0;
+        errno = 0;
+
+        for (group[i] = 0; group[i] < groups && devs[group[i]] != dev; group[i]++)
+            ;
+        if (group[i] == groups)
+            devs[groups++] = dev;
+    }
+    free(devs);
+
+    if (groups < 2) {
+        free(group);
+        free(walk);
+        return OK_NOERROR;
+    }
+
+    walk->walkers = calloc(groups, sizeof(myfind_iter_t));
+    walk->threads = calloc(groups, sizeof(pthread_t));
+    for (size_t g = 0; g < groups && walk->walkers != NULL && walk->threads != NULL; g++) {
+        myfind_iter_t *walker = &walk->walkers[g];
+
+        // the roots are only borrowed from the main iterator
+        if ((walker->roots = calloc(count, sizeof(char *))) == NULL)
+            break;
+        for (size_t i = 0; i < count; i++) {
+            if (group[i] == g)
+                walker->roots[walker->root_count++] = iter->roots[i];
+        }
+        walker->expr = iter->expr;
+        walker->result = OK_NOERROR;
+        walker->walk = walk;
+        walker->walker = true;
+        walk->count++;
+    }
+    free(group);
+
+    if (walk->count < groups) {
+        for (size_t g = 0; g < walk->count; g++)
+            free(walk->walkers[g].roots);
+        free(walk->walkers);
+        free(walk->threads);
+        free(walk);
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    pthread_mutex_init(&walk->lock, NULL);
+    pthread_cond_init(&walk->ready, NULL);
+    pthread_cond_init(&walk->space, NULL);
+    iter->walk = walk;
+
+    for (size_t g = 0; g < groups; g++) {
+        int err = pthread_create(&walk->threads[g], NULL, walk_worker, &walk->walkers[g]);
+        if (err != 0) {
+            // the entries already read are discarded, so start over in the main thread
+            error(ERR_NONCRITICAL, err, "can't start thread for parallel roots");
+            walk_stop(iter);
+            return OK_NOERROR;
+        }
+
+        pthread_mutex_lock(&walk->lock);
+        walk->active++;
+        pthread_mutex_unlock(&walk->lock);
+        walk->started++;
+    }
+
+    debug_print("DEBUG: started %lu threads for %lu roots\n", (unsigned long)groups, (unsigned long)count);
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Übergibt einen von einem walker gelesenen Eintrag an den Haupt-Thread.
+ *
+ * Ist die Warteschlange voll, wird gewartet bis der Haupt-Thread Einträge abgeholt hat.
+ *
+ * \param iter der Iterator des walkers
+ * \param file_name Pfad der Datei
+ * \param file_stat metadaten der Datei
+ *
+ * \return OK_NOERROR, OK_STOP wenn die Traversierung beendet wird oder ERR_OUT_OF_MEMORY
+ */
+static retval_t walk_submit(myfind_iter_t *iter, const char *file_name, const struct stat *file_stat) {
+    walk_t *walk = iter->walk;
+
+    walk_entry_t *entry = malloc(sizeof(walk_entry_t));
+    if (entry == NULL || (entry->path = strdup(file_name)) == NULL) {
+        free(entry);
+        return ERR_OUT_OF_MEMORY;
+    }
+    entry->next = NULL;
+    entry->stat = *file_stat;
+    entry->depth = iter->depth;
+    entry->walker = iter;
+
+    pthread_mutex_lock(&walk->lock);
+    while (walk->queued >= WALK_QUEUE_SIZE && !walk->shutdown)
+        pthread_cond_wait(&walk->space, &walk->lock);
+
+    if (walk->shutdown) {
+        pthread_mutex_unlock(&walk->lock);
+        free(entry->path);
+        free(entry);
+        return OK_STOP;
+    }
+
+    if (walk->tail != NULL)
+        walk->tail->next = entry;
+    else
+        walk->head = entry;
+    walk->tail = entry;
+    walk->queued++;
+
+    pthread_cond_signal(&walk->ready);
+    pthread_mutex_unlock(&walk->lock);
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Wertet den nächsten von den walkern gelesenen Eintrag im Haupt-Thread aus.
+ *
+ * Für -du merkt sich der Haupt-Thread pro walker das zuletzt gesehene Verzeichnis jeder Tiefe. Da die Einträge
+ * eines walkers in der Reihenfolge der Tiefensuche ankommen, ist das immer das Verzeichnis in dem der Eintrag liegt.
+ *
+ * \param iter der Iterator des Haupt-Threads
+ *
+ * \func du_enter() ordnet den Eintrag einem Verzeichnis der -du Tabelle zu.
+ * \func do_params() wertet die Expression aus.
+ *
+ * \return OK_NOERROR, OK_STOP wenn alle walker fertig sind oder einen negativen Error-Code
+ */
+static retval_t walk_next(myfind_iter_t *iter) {
+    walk_t *walk = iter->walk;
+    du_t *du = iter->expr->du;
+    retval_t result = OK_NOERROR;
+
+    pthread_mutex_lock(&walk->lock);
+    while (walk->head == NULL && walk->active > 0)
+        pthread_cond_wait(&walk->ready, &walk->lock);
+
+    walk_entry_t *entry = walk->head;
+    if (entry != NULL) {
+        if ((walk->head = entry->next) == NULL)
+            walk->tail = NULL;
+        walk->queued--;
+        pthread_cond_signal(&walk->space);
+    } else {
+        // all walkers are done, report the first error of them
+        result = OK_STOP;
+        for (size_t i = 0; i < walk->count && result == OK_STOP; i++) {
+            if (walk->walkers[i].result < 0)
+                result = walk->walkers[i].result;
+        }
+    }
+    pthread_mutex_unlock(&walk->lock);
+
+    if (entry == NULL)
+        return result;
+
+    myfind_iter_t *walker = entry->walker;
+    param_context_t paramc = {entry->path, &entry->stat, DU_NONE};
+
+    if (du != NULL) {
+        result = du_enter(du, &paramc, entry->depth, (entry->depth > 0) ? walker->du_dirs[entry->depth - 1] : DU_NONE);
+
+        if (result == OK_NOERROR && S_ISDIR(entry->stat.st_mode) && entry->depth >= walker->du_depth) {
+            size_t depth = (walker->du_depth == 0) ? FRAMES_INITIAL : walker->du_depth * 2;
+            size_t *tmp = realloc(walker->du_dirs, depth * sizeof(size_t));
+            if (tmp == NULL)
+                result = ERR_OUT_OF_MEMORY;
+            else {
+                walker->du_dirs = tmp;
+                walker->du_depth = depth;
+            }
+        }
+        if (result == OK_NOERROR && S_ISDIR(entry->stat.st_mode))
+            walker->du_dirs[entry->depth] = paramc.dir;
+    }
+
+    if (result == OK_NOERROR)
+        result = do_params(&paramc, iter->expr);
+
+    free(entry->path);
+    free(entry);
+    return result;
+}
+
+/**
+ * \brief Thread-Funktion der parallelen Traversierung
+ *
+ * Durchläuft die Start-Verzeichnisse des walkers bis alle gelesen sind oder die Traversierung beendet wird.
+ *
+ * \param arg der Iterator des walkers
+ *
+ * \func prefetch_start() startet bei Bedarf den Hilfs-Thread zum Vorauslesen für die Start-Verzeichnisse des walkers
+ *
+ * \return NULL
+ */
+static void *walk_worker(void *arg) {
+    myfind_iter_t *iter = arg;
+    walk_t *walk = iter->walk;
+    retval_t result = OK_NOERROR;
+
+    if (iter->expr->options.prefetch)
+        result = prefetch_start(iter);
+
+    while (result == OK_NOERROR)
+        result = do_next(iter);
+
+    while (iter->depth > 0)
+        pop_frame(iter);
+    prefetch_stop(iter);
+
+    pthread_mutex_lock(&walk->lock);
+    iter->result = (result < 0) ? result : OK_NOERROR;
+    walk->active--;
+    pthread_cond_signal(&walk->ready);
+    pthread_mutex_unlock(&walk->lock);
+
+    return NULL;
+}
+
+/**
+ * \brief Beendet die parallele Traversierung und gibt sie frei.
+ *
+ * Die walker werden bei ihrem nächsten Eintrag beendet, noch nicht ausgewertete Einträge werden verworfen.
+ *
+ * \param iter der Iterator des Haupt-Threads
+ */
+static void walk_stop(myfind_iter_t *iter) {
+    walk_t *walk = iter->walk;
+
+    if (walk == NULL)
+        return;
+
+    pthread_mutex_lock(&walk->lock);
+    walk->shutdown = true;
+    pthread_cond_broadcast(&walk->space);
+    pthread_mutex_unlock(&walk->lock);
+
+    for (size_t i = 0; i < walk->started; i++)
+        pthread_join(walk->threads[i], NULL);
+
+    while (walk->head != NULL) {
+        walk_entry_t *next = walk->head->next;
+        free(walk->head->path);
+        free(walk->head);
+        walk->head = next;
+    }
+
+    for (size_t i = 0; i < walk->count; i++) {
+        free(walk->walkers[i].roots);
+        free(walk->walkers[i].frames);
+        devino_free(&walk->walkers[i].ancestors);
+        free(walk->walkers[i].du_dirs);
+    }
+
+    pthread_cond_destroy(&walk->space);
+    pthread_cond_destroy(&walk->ready);
+    pthread_mutex_destroy(&walk->lock);
+    free(walk->walkers);
+    free(walk->threads);
+    free(walk);
+    iter->walk = NULL;
+}
+
+/**
+ * \brief Startet den Hilfs-Thread zum Vorauslesen der Verzeichnisse.
+ *
+ * \param iter der Iterator dessen Start-Verzeichnisse vorausgelesen werden
+ *
+ * \func pthread_create() startet den Thread mit prefetch_worker()
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t prefetch_start(myfind_iter_t *iter) {
+    prefetch_t *prefetch = calloc(1, sizeof(prefetch_t));
+    if (prefetch == NULL)
+        return ERR_OUT_OF_MEMORY;
+
+    prefetch->roots = iter->roots;
+    prefetch->root_count = iter->root_count;
+    prefetch->options = iter->expr->options;
+    pthread_mutex_init(&prefetch->lock, NULL);
+    pthread_cond_init(&prefetch->moved, NULL);
+
+    int err = pthread_create(&prefetch->thread, NULL, prefetch_worker, prefetch);
+    if (err != 0) {
+        // prefetching is only an optimization
+        error(ERR_NONCRITICAL, err, "can't start thread for prefetch");
+        pthread_cond_destroy(&prefetch->moved);
+        pthread_mutex_destroy(&prefetch->lock);
+        free(prefetch);
+        return OK_NOERROR;
+    }
+
+    iter->prefetch = prefetch;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Meldet dem Hilfs-Thread, dass die Traversierung ein weiteres Verzeichnis geöffnet hat.
+ *
+ * \param prefetch Hilfs-Thread
+ */
+static void prefetch_opened(prefetch_t *prefetch) {
+    pthread_mutex_lock(&prefetch->lock);
+    prefetch->opened++;
+    pthread_cond_signal(&prefetch->moved);
+    pthread_mutex_unlock(&prefetch->lock);
+}
+
+/**
+ * \brief Thread-Funktion des Hilfs-Threads zum Vorauslesen
+ *
+ * \param arg der Hilfs-Thread
+ *
+ * \func stat_entry() liest das Start-Verzeichnis wie die Traversierung (-H, -L)
+ * \func prefetch_dir() liest ein Start-Verzeichnis voraus
+ *
+ * \return NULL
+ */
+static void *prefetch_worker(void *arg) {
+    prefetch_t *prefetch = arg;
+    struct stat st;
+
+    for (size_t i = 0; i < prefetch->root_count; i++) {
+        if (stat_entry(prefetch->roots[i], &st, prefetch->options.follow != FOLLOW_NEVER) == 0 &&
+            S_ISDIR(st.st_mode) && !prefetch_dir(prefetch, prefetch->roots[i]))
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Liest ein Verzeichnis, die Inodes seiner Einträge und danach rekursiv seine Unterverzeichnisse.
+ *
+ * Die Einträge werden in derselben Reihenfolge wie von do_dir_sorted() gelesen und verarbeitet.
+ * Der Directory-Stream wird vor der Rekursion geschlossen, damit die Tiefe nicht durch offene Dateien begrenzt ist.
+ *
+ * \param prefetch Hilfs-Thread
+ * \param dir_name Pfad des Verzeichnisses
+ *
+ * \func readdir() liest die Einträge (getdents)
+ * \func fstatat() liest den Inode eines Eintrags relativ zum Verzeichnis, ohne den Pfad erneut aufzulösen
+ *
+ * \return false wenn der Hilfs-Thread beendet werden soll
+ */
+static bool prefetch_dir(prefetch_t *prefetch, const char *dir_name) {
+    dir_entry_t *entries = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    struct dirent *dp;
+    bool stop;
+
+    // behind the traversal everything is already cached, far ahead it might be evicted again
+    pthread_mutex_lock(&prefetch->lock);
+    while (!prefetch->shutdown && prefetch->read >= prefetch->opened + PREFETCH_AHEAD)
+        pthread_cond_wait(&prefetch->moved, &prefetch->lock);
+    stop = prefetch->shutdown;
+    prefetch->read++;
+    pthread_mutex_unlock(&prefetch->lock);
+
+    DIR *dirp = stop ? NULL : opendir(dir_name);
+    if (dirp == NULL)
+        return !stop;
+
+    while ((dp = readdir(dirp)) != NULL) {
+        if (strcmp(dp->d_name, ".") == 0 || strcmp(dp->d_name, "..") == 0)
+            continue;
+
+        if (count == capacity) {
+            capacity = (capacity == 0) ? DIR_ENTRIES_INITIAL : capacity * 2;
+            dir_entry_t *tmp = realloc(entries, capacity * sizeof(dir_entry_t));
+            if (tmp == NULL)
+                break;
+            entries = tmp;
+        }
+        if ((entries[count].name = strdup(dp->d_name)) == NULL)
+            break;
+        entries[count].ino = dp->d_ino;
+        count++;
+    }
+
+    if (prefetch->options.inode_order)
+        qsort(entries, count, sizeof(dir_entry_t), compare_entry_ino);
+
+    // the inodes end up in the cache, the stat data is only used to find the subdirectories
+    int fd = dirfd(dirp);
+    for (size_t i = 0; i < count; i++)
+        entries[i].stat_errno = (fstatat(fd, entries[i].name, &entries[i].stat, AT_SYMLINK_NOFOLLOW) == 0) ? 0 : errno;
+    (void)closedir(dirp);
+
+    if (prefetch->options.sort_name)
+        qsort(entries, count, sizeof(dir_entry_t), compare_entry_name);
+
+    for (size_t i = 0; i < count && !stop; i++) {
+        if (entries[i].stat_errno != 0 || !S_ISDIR(entries[i].stat.st_mode))
+            continue;
+
+        size_t pathsize = strlen(dir_name) + strlen(entries[i].name) + 2; // lengths + '/' + \0
+        char path[pathsize];
+        snprintf(path, pathsize, "%s/%s", dir_name, entries[i].name);
+        stop = !prefetch_dir(prefetch, path);
+    }
+
+    free_dir_entries(entries, count);
+    return !stop;
+}
+
+/**
+ * \brief Beendet den Hilfs-Thread zum Vorauslesen und gibt ihn frei.
+ *
+ * \param iter der Iterator des Haupt-Threads
+ */
+static void prefetch_stop(myfind_iter_t *iter) {
+    prefetch_t *prefetch = iter->prefetch;
+
+    if (prefetch == NULL)
+        return;
+
+    pthread_mutex_lock(&prefetch->lock);
+    prefetch->shutdown = true;
+    pthread_cond_signal(&prefetch->moved);
+    pthread_mutex_unlock(&prefetch->lock);
+
+    pthread_join(prefetch->thread, NULL);
+
+    pthread_cond_destroy(&prefetch->moved);
+    pthread_mutex_destroy(&prefetch->lock);
+    free(prefetch);
+    iter->prefetch = NULL;
+}
+
+/**
+ * \brief Setzt die Begrenzung und die Statistik für eine neue Traversierung zurück.
+ *
+ * \param throttle die Begrenzung der Expression
+ * \param options Optionen der Traversierung
+ */
+static void throttle_start(throttle_t *throttle, const myfind_options_t *options) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    throttle->enabled = options->max_rate > 0 || options->max_dir_rate > 0 || options->backoff_latency > 0 ||
+                        options->stats;
+    throttle->entries = (bucket_t){(double)options->max_rate, 0, 0, timespec_to_ns(&now)};
+    throttle->dirs = (bucket_t){(double)options->max_dir_rate, 0, 0, timespec_to_ns(&now)};
+    // a tenth of a second may be done at once, so the rate is kept without a syscall pause for every entry
+    throttle->entries.burst = (options->max_rate > THROTTLE_BURSTS) ? throttle->entries.rate / THROTTLE_BURSTS : 1.0;
+    throttle->dirs.burst = (options->max_dir_rate > THROTTLE_BURSTS) ? throttle->dirs.rate / THROTTLE_BURSTS : 1.0;
+    throttle->entries.tokens = throttle->entries.burst;
+    throttle->dirs.tokens = throttle->dirs.burst;
+    throttle->latency_max = options->backoff_latency * NSEC_PER_MSEC;
+    throttle->delay = 0;
+    throttle->started = timespec_to_ns(&now);
+    throttle->entry_count = throttle->dir_count = throttle->slow_count = 0;
+    throttle->read_time = throttle->rate_wait = throttle->backoff_wait = throttle->delay_max = 0;
+}
+
+/**
+ * \brief Zählt einen Eintrag und wartet mit --max-rate bis dafür ein Token verfügbar ist.
+ *
+ * \param throttle die Begrenzung der Expression
+ *
+ * \func bucket_take() nimmt das Token
+ * \func throttle_sleep() wartet außerhalb des Locks
+ */
+static void throttle_entry(throttle_t *throttle) {
+    if (!throttle->enabled)
+        return;
+
+    pthread_mutex_lock(&throttle->lock);
+    throttle->entry_count++;
+    int64_t wait = bucket_take(&throttle->entries);
+    throttle->rate_wait += wait;
+    pthread_mutex_unlock(&throttle->lock);
+
+    throttle_sleep(wait);
+}
+
+/**
+ * \brief Wartet vor dem Lesen eines Verzeichnisses auf ein Token von --max-dir-rate und die Pause des Ausweichens.
+ *
+ * \param throttle die Begrenzung der Expression
+ *
+ * \func bucket_take() nimmt das Token
+ * \func throttle_sleep() wartet außerhalb des Locks
+ *
+ * \return Zeitpunkt nach dem Warten (siehe throttle_clock()), Beginn der Lesezeit für throttle_dir_done()
+ */
+static int64_t throttle_dir(throttle_t *throttle) {
+    if (!throttle->enabled)
+        return 0;
+
+    pthread_mutex_lock(&throttle->lock);
+    int64_t wait = bucket_take(&throttle->dirs);
+    throttle->rate_wait += wait;
+    throttle->backoff_wait += throttle->delay;
+    wait += throttle->delay;
+    pthread_mutex_unlock(&throttle->lock);
+
+    throttle_sleep(wait);
+    return throttle_clock(throttle);
+}
+
+/**
+ * \brief Zählt ein gelesenes Verzeichnis und passt die Pause des Ausweichens an dessen Lesezeit an.
+ *
+ * \param throttle die Begrenzung der Expression
+ * \param latency Zeit für opendir() und das Lesen aller Einträge in Nanosekunden
+ */
+static void throttle_dir_done(throttle_t *throttle, int64_t latency) {
+    if (!throttle->enabled)
+        return;
+
+    pthread_mutex_lock(&throttle->lock);
+    throttle->dir_count++;
+    throttle->read_time += latency;
+
+    if (throttle->latency_max > 0 && latency > throttle->latency_max) {
+        throttle->slow_count++;
+        throttle->delay = (throttle->delay == 0) ? THROTTLE_DELAY_MIN : throttle->delay * 2;
+        if (throttle->delay > THROTTLE_DELAY_MAX)
+            throttle->delay = THROTTLE_DELAY_MAX;
+        if (throttle->delay > throttle->delay_max)
+            throttle->delay_max = throttle->delay;
+    } else if (throttle->delay > 0) {
+        throttle->delay -= throttle->delay / 8;
+        if (throttle->delay < THROTTLE_DELAY_MIN)
+            throttle->delay = 0;
+    }
+    pthread_mutex_unlock(&throttle->lock);
+}
+
+/**
+ * \brief Nimmt ein Token aus einem Token-Bucket, der Lock der Begrenzung muss gehalten werden.
+ *
+ * \param bucket der Token-Bucket
+ *
+ * \return die Wartezeit in Nanosekunden bis das Token nachgefüllt ist, 0 wenn es sofort verfügbar war
+ */
+static int64_t bucket_take(bucket_t *bucket) {
+    struct timespec now;
+
+    if (bucket->rate <= 0)
+        return 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t ns = timespec_to_ns(&now);
+    if (ns > bucket->filled) {
+        bucket->tokens += (double)(ns - bucket->filled) * bucket->rate / 1e9;
+        if (bucket->tokens > bucket->burst)
+            bucket->tokens = bucket->burst;
+        bucket->filled = ns;
+    }
+
+    bucket->tokens -= 1.0;
+    return (bucket->tokens < 0) ? (int64_t)(-bucket->tokens / bucket->rate * 1e9) : 0;
+}
+
+/**
+ * \brief Liefert die aktuelle Zeit für die Messung der Lesezeit von Verzeichnissen.
+ *
+ * \param throttle die Begrenzung der Expression
+ *
+ * \return CLOCK_MONOTONIC in Nanosekunden oder 0 wenn keine Begrenzung gesetzt ist (dann wird nicht gemessen)
+ */
+static int64_t throttle_clock(const throttle_t *throttle) {
+    struct timespec now;
+
+    if (!throttle->enabled)
+        return 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return timespec_to_ns(&now);
+}
+
+/**
+ * \brief Wartet die angegebene Zeit, auch wenn nanosleep() von einem Signal unterbrochen wird.
+ *
+ * \param ns Wartezeit in Nanosekunden
+ */
+static void throttle_sleep(int64_t ns) {
+    struct timespec ts = {ns / NSEC_PER_SEC, ns % NSEC_PER_SEC};
+
+    if (ns <= 0)
+        return;
+
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+        ;
+    errno = 0;
+}
+
+/**
+ * \brief Gibt die Statistik einer Traversierung auf stderr aus (--stats).
+ *
+ * Die Raten sind die tatsächlich erreichten, also inklusive aller Wartezeiten.
+ *
+ * \param throttle die Begrenzung der Expression
+ */
+static void throttle_report(throttle_t *throttle) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    pthread_mutex_lock(&throttle->lock);
+    double elapsed = (double)(timespec_to_ns(&now) - throttle->started) / 1e9;
+    double seconds = (elapsed > 0) ? elapsed : 1e-9;
+
+    (void)fprintf(stderr,
+                  "Statistics:\n"
+                  "  elapsed       %12.3f s\n"
+                  "  entries       %12llu  (%.1f/s)\n"
+                  "  directories   %12llu  (%.1f/s, avg read %.3f ms)\n"
+                  "  rate waits    %12.3f s\n"
+                  "  backoff       %12.3f s  (%llu slow directories, max delay %.1f ms)\n",
+                  elapsed, (unsigned long long)throttle->entry_count, (double)throttle->entry_count / seconds,
+                  (unsigned long long)throttle->dir_count, (double)throttle->dir_count / seconds,
+                  (throttle->dir_count > 0) ? (double)throttle->read_time / (double)throttle->dir_count / 1e6 : 0.0,
+                  (double)throttle->rate_wait / 1e9, (double)throttle->backoff_wait / 1e9,
+                  (unsigned long long)throttle->slow_count, (double)throttle->delay_max / 1e6);
+    pthread_mutex_unlock(&throttle->lock);
+}
+
+/**
+ * \brief Prüft ob die Expression mit --checkpoint bzw. --resume verwendet werden kann.
+ *
+ * Im Checkpoint steht nur die Position der Traversierung. Die gesammelten Daten von -du und -dupes sowie die
+ * Reihenfolge der parallelen Traversierung und des Vorauslesens können damit nicht wiederhergestellt werden.
+ *
+ * \param expr die übersetzte Expression
+ *
+ * \return true wenn die Expression unterstützt wird
+ */
+static bool checkpoint_supported(const expression_t *expr) {
+    if (expr->options.parallel_roots || expr->options.prefetch || expr->du != NULL)
+        return false;
+
+    for (size_t i = 0; i < expr->count; i++) {
+        if (expr->params[i].opt == DUPES)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Schreibt den Checkpoint, wenn seit dem letzten mehr als CHECKPOINT_INTERVAL Sekunden vergangen sind.
+ *
+ * Der Checkpoint darf nur Einträge als erledigt vermerken deren Ausgabe bereits geschrieben ist. Daher werden
+ * vorher die Aufträge von -contains abgeschlossen, gesammelte -exec Pfade ausgeführt, alle Kommandos abgewartet
+ * und die Ausgaben der Expression auf stdout geleert. Entstehen dabei noch Treffer, wird der Checkpoint erst nach
+ * deren Abgabe geschrieben.
+ *
+ * \param iter der Iterator, es dürfen keine Treffer mehr zur Abgabe anstehen
+ *
+ * \func content_drain() schließt alle Aufträge von -contains ab
+ * \func exec_flush() führt gesammelte -exec Pfade aus
+ * \func options.output() liefert die Position der Ausgabe des Aufrufers, falls gesetzt
+ * \func checkpoint_write() schreibt den Checkpoint
+ *
+ * \return OK_NOERROR, OK_DEFERRED wenn zuerst Treffer abgegeben werden müssen oder einen negativen Error-Code
+ */
+static retval_t checkpoint_update(myfind_iter_t *iter) {
+    expression_t *expr = iter->expr;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (timespec_to_ns(&now) < iter->checkpoint_at)
+        return OK_NOERROR;
+
+    retval_t result = content_drain(expr->content, true);
+    if (result != OK_NOERROR)
+        return result;
+    if (iter->match_count > 0 || iter->quit)
+        return OK_DEFERRED;
+
+    for (size_t i = 0; i < expr->count; i++) {
+        if (expr->params[i].opt == EXEC && expr->params[i].exec->batch &&
+            (result = exec_flush(expr->params[i].exec)) < 0)
+            return result;
+    }
+    exec_wait(&expr->pool, 0);
+
+    // only the output of actions like -print and -ls belongs to libmyfind, the caller completes its own
+    errno = 0;
+    if (expr->has_action && fflush(stdout) != 0)
+        return ERR_OUTPUT_BROKEN;
+
+    myfind_position_t position = {.offset = -1};
+    if (expr->options.output != NULL &&
+        (result = expr->options.output(&position, false, expr->options.output_data)) < 0)
+        return result;
+
+    // a failed checkpoint only costs work after a restart, so the traversal goes on
+    if (!checkpoint_write(iter, &position)) {
+        error(ERR_NONCRITICAL, errno, "can't write checkpoint '%s'", expr->options.checkpoint);
+        errno = 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    iter->checkpoint_at = timespec_to_ns(&now) + CHECKPOINT_INTERVAL * NSEC_PER_SEC;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Schreibt die Position der Traversierung atomar in die Checkpoint-Datei.
+ *
+ * Gespeichert werden die Start-Verzeichnisse, das aktuelle Start-Verzeichnis, die Position der Ausgabe des Aufrufers,
+ * die Zähler von -limit und pro offenem Verzeichnis dessen Pfad und der Name des zuletzt verarbeiteten Eintrags.
+ * Da die Einträge mit --checkpoint immer nach Namen sortiert verarbeitet werden, genügt dieser Name für die
+ * Position im Verzeichnis, auch wenn sich das Verzeichnis bis zum Fortsetzen ändert.
+ *
+ * Die Datei wird zuerst unter FILE.tmp geschrieben und mit fsync() gesichert, erst danach ersetzt rename()
+ * den bisherigen Checkpoint. Nach einem Absturz gibt es daher immer einen vollständigen Checkpoint.
+ *
+ * \param iter der Iterator
+ * \param position die Position der Ausgabe (siehe myfind_output_t), offset -1 wenn es keine gibt
+ *
+ * \func fsync() schreibt die Datei und danach das Verzeichnis mit dem neuen Eintrag auf die Platte
+ * \func rename() ersetzt den Checkpoint atomar
+ *
+ * \return true wenn erfolgreich, sonst ist errno gesetzt
+ */
+static bool checkpoint_write(const myfind_iter_t *iter, const myfind_position_t *position) {
+    const expression_t *expr = iter->expr;
+    const char *file_name = expr->options.checkpoint;
+    size_t namesize = strlen(file_name) + sizeof(CHECKPOINT_SUFFIX);
+    char tmp_name[namesize];
+    char dir_name[namesize];
+    size_t limits = 0;
+
+    snprintf(tmp_name, namesize, "%s" CHECKPOINT_SUFFIX, file_name);
+    FILE *fp = fopen(tmp_name, "w");
+    if (fp == NULL)
+        return false;
+
+    fprintf(fp, "%s %d\nroots %lu\n", CHECKPOINT_MAGIC, CHECKPOINT_VERSION, (unsigned long)iter->root_count);
+    for (size_t i = 0; i < iter->root_count; i++)
+        checkpoint_put(fp, iter->roots[i]);
+
+    for (size_t i = 0; i < expr->count; i++)
+        limits += (expr->params[i].opt == LIMIT);
+    fprintf(fp, "next %lu\noutput %llu %llu %lld\nlimits %lu\n", (unsigned long)iter->root_next,
+            (unsigned long long)position->dev, (unsigned long long)position->ino, (long long)position->offset,
+            (unsigned long)limits);
+    for (size_t i = 0; i < expr->count; i++) {
+        if (expr->params[i].opt == LIMIT)
+            fprintf(fp, "%lld\n", (long long)*expr->params[i].hits);
+    }
+
+    // the entries are always buffered, the one at next - 1 is the entry processed last
+    fprintf(fp, "frames %lu\n", (unsigned long)iter->depth);
+    for (size_t i = 0; i < iter->depth; i++) {
+        const frame_t *frame = &iter->frames[i];
+        checkpoint_put(fp, frame->path);
+        checkpoint_put(fp, (frame->next > 0) ? frame->entries[frame->next - 1].name : "");
+    }
+
+    bool ok = (fflush(fp) == 0 && fsync(fileno(fp)) == 0);
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmp_name, file_name) == -1) {
+        int err = errno;
+        (void)unlink(tmp_name);
+        errno = err;
+        return false;
+    }
+
+    // without this the rename itself may be lost on a crash
+    snprintf(dir_name, namesize, "%s", file_name);
+    int fd = open(dirname(dir_name), O_RDONLY | O_DIRECTORY);
+    if (fd != -1) {
+        (void)fsync(fd);
+        (void)close(fd);
+    }
+    errno = 0;
+
+    return true;
+}
+
+/**
+ * \brief Setzt eine Traversierung an der Position einer Checkpoint-Datei fort.
+ *
+ * Existiert die Datei nicht, beginnt die Traversierung von vorne. So kann derselbe Aufruf mit
+ * --checkpoint FILE --resume FILE nach jedem Abbruch wiederholt werden.
+ *
+ * \param iter der neue Iterator, die Start-Verzeichnisse sind bereits gesetzt
+ * \param file_name Pfad der Checkpoint-Datei
+ *
+ * \func checkpoint_resume() liest die Datei und stellt den Stack der Verzeichnisse wieder her
+ * \func options.output() erhält die gespeicherte Position der Ausgabe, falls gesetzt. Was mit der Ausgabe nach
+ *      dem Checkpoint geschieht, entscheidet der Aufrufer.
+ *
+ * \return OK_NOERROR, ERR_INVALID_ARGUMENT wenn die Datei nicht gelesen werden kann oder nicht zu den
+ *         Start-Verzeichnissen bzw. der Expression passt, ERR_OUT_OF_MEMORY oder den Error-Code von options.output()
+ */
+static retval_t checkpoint_read(myfind_iter_t *iter, const char *file_name) {
+    const myfind_options_t *options = &iter->expr->options;
+    myfind_position_t position = {.offset = -1};
+
+    FILE *fp = fopen(file_name, "r");
+    if (fp == NULL && errno == ENOENT) {
+        errno = 0;
+        return OK_NOERROR;
+    }
+    if (fp == NULL) {
+        error(ERR_NONCRITICAL, errno, "can't read checkpoint '%s'", file_name);
+        errno = 0;
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    retval_t result = checkpoint_resume(iter, fp, &position);
+    (void)fclose(fp);
+
+    if (result == ERR_INVALID_ARGUMENT)
+        error(ERR_NONCRITICAL, 0, "checkpoint '%s' is invalid or belongs to other start directories", file_name);
+    if (result != OK_NOERROR) {
+        for (size_t i = 0; i < iter->expr->count; i++) {
+            if (iter->expr->params[i].opt == LIMIT)
+                *iter->expr->params[i].hits = 0;
+        }
+        return result;
+    }
+
+    // output written after the checkpoint is produced again, the caller may cut it off
+    if (options->output != NULL && (result = options->output(&position, true, options->output_data)) < 0)
+        return result;
+
+    debug_print("DEBUG: resumed at root %lu with %lu open dirs\n", (unsigned long)iter->root_next,
+                (unsigned long)iter->depth);
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Liest den Inhalt einer Checkpoint-Datei (siehe checkpoint_write()) in den Iterator.
+ *
+ * \param iter der neue Iterator
+ * \param fp geöffnete Checkpoint-Datei
+ * \param position Ausgabe-Pointer für die Position der Ausgabe beim Checkpoint (siehe myfind_output_t)
+ *
+ * \func checkpoint_resume_frame() öffnet ein gespeichertes Verzeichnis wieder
+ *
+ * \return OK_NOERROR, ERR_INVALID_ARGUMENT oder ERR_OUT_OF_MEMORY
+ */
+static retval_t checkpoint_resume(myfind_iter_t *iter, FILE *fp, myfind_position_t *position) {
+    const expression_t *expr = iter->expr;
+    unsigned long count = 0;
+    unsigned long next = 0;
+    unsigned long limits = 0;
+    unsigned long depth = 0;
+    unsigned long long dev = 0;
+    unsigned long long ino = 0;
+    long long pos = -1;
+    int version = 0;
+    bool lost = false;
+
+    bool valid = fscanf(fp, CHECKPOINT_MAGIC " %d roots %lu", &version, &count) == 2 &&
+                 version == CHECKPOINT_VERSION && count == iter->root_count;
+    for (size_t i = 0; i < count && valid; i++) {
+        char *root = checkpoint_get(fp);
+        valid = (root != NULL && strcmp(root, iter->roots[i]) == 0);
+        free(root);
+    }
+
+    valid = valid && fscanf(fp, " next %lu output %llu %llu %lld limits %lu", &next, &dev, &ino, &pos, &limits) == 5 &&
+            next <= count;
+    for (size_t i = 0; i < expr->count && valid; i++) {
+        long long hits;
+        if (expr->params[i].opt != LIMIT)
+            continue;
+        valid = (limits-- > 0 && fscanf(fp, "%lld", &hits) == 1 && hits >= 0);
+        if (valid)
+            *expr->params[i].hits = hits;
+    }
+    valid = valid && limits == 0 && fscanf(fp, " frames %lu", &depth) == 1 && (depth == 0 || next > 0);
+    if (!valid)
+        return ERR_INVALID_ARGUMENT;
+
+    iter->root_next = (size_t)next;
+    position->dev = (uint64_t)dev;
+    position->ino = (uint64_t)ino;
+    position->offset = (int64_t)pos;
+
+    for (size_t i = 0; i < depth; i++) {
+        char *path = checkpoint_get(fp);
+        char *last = checkpoint_get(fp);
+        retval_t result = (path == NULL || last == NULL) ? ERR_INVALID_ARGUMENT : OK_NOERROR;
+
+        // a directory that is gone takes the directories below it with it
+        if (result == OK_NOERROR && !lost)
+            result = checkpoint_resume_frame(iter, path, last, &lost);
+
+        free(path);
+        free(last);
+        if (result != OK_NOERROR)
+            return result;
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Öffnet ein Verzeichnis aus dem Checkpoint wieder und überspringt die bereits verarbeiteten Einträge.
+ *
+ * Das Verzeichnis selbst wurde bereits ausgewertet, es wird daher nur auf den Stack gelegt.
+ *
+ * \param iter der Iterator
+ * \param path Pfad des Verzeichnisses
+ * \param last Name des zuletzt verarbeiteten Eintrags oder "" wenn noch keiner verarbeitet wurde
+ * \param lost Ausgabe-Pointer, wird true wenn das Verzeichnis nicht mehr geöffnet werden kann
+ *
+ * \func do_dir() öffnet das Verzeichnis und puffert die nach Namen sortierten Einträge
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t checkpoint_resume_frame(myfind_iter_t *iter, const char *path, const char *last, bool *lost) {
+    follow_t follow = iter->expr->options.follow;
+    size_t depth = iter->depth;
+    struct stat st;
+
+    if (stat_entry(path, &st, follow == FOLLOW_ALWAYS || (follow == FOLLOW_ROOTS && depth == 0)) == -1 ||
+        !S_ISDIR(st.st_mode)) {
+        error(ERR_NONCRITICAL, errno, "can't resume in '%s'", path);
+        errno = 0;
+        *lost = true;
+        return OK_NOERROR;
+    }
+
+    param_context_t paramc = {path, &st, DU_NONE};
+    retval_t result = do_dir(iter, &paramc);
+    if (result != OK_NOERROR || iter->depth == depth) {
+        *lost = true;
+        return result;
+    }
+
+    frame_t *frame = &iter->frames[depth];
+    while (frame->next < frame->count && strcmp(frame->entries[frame->next].name, last) <= 0)
+        frame->next++;
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Schreibt eine Zeichenkette als "Länge:Bytes" in eine Zeile, damit Pfade beliebige Zeichen enthalten können.
+ *
+ * \param fp Checkpoint-Datei
+ * \param string Zeichenkette
+ */
+static void checkpoint_put(FILE *fp, const char *string) {
+    size_t len = strlen(string);
+
+    fprintf(fp, "%lu:", (unsigned long)len);
+    (void)fwrite(string, 1, len, fp);
+    (void)fputc('\n', fp);
+}
+
+/**
+ * \brief Liest eine mit checkpoint_put() geschriebene Zeichenkette.
+ *
+ * \param fp Checkpoint-Datei
+ *
+ * \return die allokierte Zeichenkette oder NULL wenn die Datei ungültig ist bzw. kein Speicher frei ist
+ */
+static char *checkpoint_get(FILE *fp) {
+    unsigned long len;
+
+    if (fscanf(fp, "%lu:", &len) != 1 || len > CHECKPOINT_STRING_MAX)
+        return NULL;
+
+    char *string = malloc(len + 1);
+    if (string == NULL)
+        return NULL;
+
+    if (fread(string, 1, len, fp) != len || fgetc(fp) != '\n' || memchr(string, '\0', len) != NULL) {
+        free(string);
+        return NULL;
+    }
+
+    string[len] = '\0';
+    return string;
+}
+
+/**
+ * \brief Verarbeitet den nächsten Eintrag der Traversierung.
+ *
+ * Ist der Stack leer, wird das nächste Start-Verzeichnis verarbeitet, sonst der nächste Eintrag des obersten
+ * Verzeichnisses auf dem Stack. Ist ein Verzeichnis fertig gelesen, wird es vom Stack genommen.
+ * Die Reihenfolge entspricht damit einer rekursiven Tiefensuche pro Start-Verzeichnis.
+ *
+ * \param iter der Iterator
+ *
+ * \func walk_next() wertet bei der parallelen Traversierung den nächsten gelesenen Eintrag aus.
+ * \func readdir() liefert einen Pointer zu einem "struct dirent" der den Eintrag beschreibt.
+ * \func throttle_entry() wartet mit --max-rate auf ein Token für den Eintrag.
+ * \func do_file() bzw. do_entry() verarbeiten den Eintrag.
+ * \func pop_frame() schließt ein fertig gelesenes Verzeichnis.
+ *
+ * \return OK_NOERROR, OK_STOP wenn es keine Einträge mehr gibt oder einen negativen Error-Code
+ */
+static retval_t do_next(myfind_iter_t *iter) {
+    throttle_t *throttle = &iter->expr->throttle;
+    struct dirent *dp;
+
+    if (iter->walk != NULL && !iter->walker)
+        return walk_next(iter);
+
+    // the next start directory is processed once the previous one is completely done
+    if (iter->depth == 0) {
+        if (iter->root_next == iter->root_count)
+            return OK_STOP;
+        throttle_entry(throttle);
+        return do_file(iter, iter->roots[iter->root_next++]);
+    }
+
+    while (iter->depth > 0) {
+        frame_t *frame = &iter->frames[iter->depth - 1];
+        dir_entry_t *entry = NULL;
+        const char *name;
+
+        if (frame->dirp != NULL) {
+            int64_t start = throttle_clock(throttle);
+
+            // readdir returns (NULL && errno=0) on EOF, (NULL && errno != 0) is not EOF!
+            // errno is reset before every call, because processing an entry may leave it set.
+            for (errno = 0; (dp = readdir(frame->dirp)) != NULL; errno = 0) {
+                // leave "." and ".." links alone
+                if (strcmp(dp->d_name, ".") != 0 && strcmp(dp->d_name, "..") != 0)
+                    break;
+            }
+            frame->read_time += throttle_clock(throttle) - start;
+
+            if (dp == NULL) {
+                // if readdir throws an error, print it and stop reading this dir
+                if (errno != 0) {
+                    error(ERR_NONCRITICAL, errno, "can't read dir '%s'", frame->path);
+                    errno = 0;
+                }
+                throttle_dir_done(throttle, frame->read_time);
+                pop_frame(iter);
+                continue;
+            }
+            name = dp->d_name;
+        } else if (frame->next < frame->count) {
+            entry = &frame->entries[frame->next++];
+            name = entry->name;
+        } else {
+            pop_frame(iter);
+            continue;
+        }
+
+        throttle_entry(throttle);
+
+        // build path
+        size_t pathsize = strlen(frame->path) + strlen(name) + 2; // lengths + '/' + \0
+        char path[pathsize];
+        snprintf(path, pathsize, "%s/%s", frame->path, name);
+
+        debug_print("DEBUG: next entry '%s'\n", path);
+
+        // process found file or directory, buffered entries may already have been stat'd
+        if (entry == NULL || entry->stat_errno == -1)
+            return do_file(iter, path);
+        if (entry->stat_errno != 0) {
+            error(ERR_NONCRITICAL, entry->stat_errno, "can't get stat of '%s'", path);
+            return OK_NOERROR;
+        }
+        return do_entry(iter, path, &entry->stat);
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Diese Funktion überprüft ob es sich um ein directory handelt oder nicht
+ *        und ruft, wenn kein Fehler passiert ist, do_params() auf.
+ *
+ * Wird ein Directory erkannt, wird zusätzlich do_dir aufgerufen.
+ * Wird ein Fehler beim auslesen der Attribute erkannt wird die Verarbeitung abgebrochen.
+ *
+ * \param iter der Iterator der Traversierung
+ * \param file_name ist der relative Pfad der zu prüfenden Datei
+ *
+ * \func stat_entry() ließt die file-Attribute aus und speichert sie in einen Buffer, mit -L bzw. für das
+ *      Start-Verzeichnis mit -H wird dabei symbolischen Links gefolgt
+ * \func do_entry() wird aufgerufen um die Parameter zu verarbeiten und ggf. das Directory zu öffnen.
+ *
+ * \return einen Statuscode der Auskunft über mögliche Fehler bei der Verarbeitung gibt
+ */
+static retval_t do_file(myfind_iter_t *iter, const char *file_name) {
+    follow_t follow = iter->expr->options.follow;
+    retval_t result;
+    struct stat status;
+
+    debug_print("DEBUG: do_file '%s'\n", file_name);
+
+    errno = 0;
+    if (stat_entry(file_name, &status, follow == FOLLOW_ALWAYS || (follow == FOLLOW_ROOTS && iter->depth == 0)) == -1) {
+        error(ERR_NONCRITICAL, errno, "can't get stat of '%s'", file_name);
+        errno = 0;
+        result = OK_NOERROR; // do not panic on unreadable stat
+    } else {
+        result = do_entry(iter, file_name, &status);
+    }
+
+    debug_print("DEBUG: ended do_file with '%d' \n", result);
+    return result;
+}
+
+/**
+ * \brief Verarbeitet eine Datei deren Metadaten bereits gelesen wurden.
+ *
+ * Ein walker der parallelen Traversierung wertet die Expression nicht aus, sondern übergibt den Eintrag
+ * an den Haupt-Thread und geht sofort in Verzeichnisse hinein.
+ *
+ * \param iter der Iterator der Traversierung
+ * \param file_name ist der relative Pfad der zu prüfenden Datei
+ * \param file_stat ein Pointer auf das stat-struct der zu prüfenden Datei
+ *
+ * \func walk_submit() übergibt den Eintrag eines walkers an den Haupt-Thread.
+ * \func du_enter() ordnet den Eintrag einem Verzeichnis der -du Tabelle zu.
+ * \func do_params() wird aufgerufen um die Parameter zu verarbeiten.
+ * \func do_dir() wird zusätzlich aufgerufen wenn es sich um ein directory handelt.
+ *
+ * \return einen Statuscode der Auskunft über mögliche Fehler bei der Verarbeitung gibt
+ */
+static retval_t do_entry(myfind_iter_t *iter, const char *file_name, struct stat *file_stat) {
+    du_t *du = iter->expr->du;
+    param_context_t paramc = {file_name, file_stat, DU_NONE};
+    retval_t result = OK_NOERROR;
+
+    // a directory reached again through a link below itself is neither evaluated nor entered, like find -L
+    if (S_ISDIR(file_stat->st_mode) && is_loop(iter, file_name, file_stat))
+        return OK_NOERROR;
+
+    if (iter->walker) {
+        result = walk_submit(iter, file_name, file_stat);
+    } else {
+        size_t parent = (iter->depth > 0) ? iter->frames[iter->depth - 1].du_dir : DU_NONE;
+        if (du != NULL)
+            result = du_enter(du, &paramc, iter->depth, parent);
+        if (result == OK_NOERROR)
+            result = do_params(&paramc, iter->expr);
+    }
+
+    // only go deeper if no error has happend and neither -quit nor -limit ended the traversal
+    if (result == OK_NOERROR && S_ISDIR(file_stat->st_mode) && !iter->quit)
+        result = do_dir(iter, &paramc);
+
+    return result;
+}
+
+/**
+ * \brief Prüft ob ein Verzeichnis bereits auf dem Stack der Traversierung liegt.
+ *
+ * Das ist nur möglich, wenn symbolischen Links gefolgt wird. Die Prüfung erfolgt über das Hash-Set der
+ * (st_dev, st_ino) Paare aller offenen Verzeichnisse und braucht daher keinen Vergleich mit jedem
+ * übergeordneten Verzeichnis. Nur für die Fehlermeldung wird das betroffene Verzeichnis im Stack gesucht.
+ *
+ * \param iter der Iterator der Traversierung
+ * \param dir_name Pfad des Verzeichnisses
+ * \param dir_stat metadaten des Verzeichnisses
+ *
+ * \return true wenn das Verzeichnis eine Schleife bildet, die Schleife wurde dann bereits gemeldet
+ */
+static bool is_loop(myfind_iter_t *iter, const char *dir_name, const struct stat *dir_stat) {
+    if (iter->expr->options.follow == FOLLOW_NEVER ||
+        !devino_contains(&iter->ancestors, dir_stat->st_dev, dir_stat->st_ino))
+        return false;
+
+    for (size_t i = 0; i < iter->depth; i++) {
+        if (iter->frames[i].dev == dir_stat->st_dev && iter->frames[i].ino == dir_stat->st_ino) {
+            error(ERR_NONCRITICAL, 0, "file system loop detected; '%s' is part of the same file system loop as '%s'",
+                  dir_name, iter->frames[i].path);
+            break;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Liest die Metadaten einer Datei, bei Bedarf wird dabei einem symbolischen Link gefolgt.
+ *
+ * Zeigt ein Link ins Leere, werden wie bei find -L die Metadaten des Links selbst verwendet.
+ *
+ * \param file_name Pfad der Datei
+ * \param file_stat Ausgabe-Pointer für die metadaten
+ * \param follow true wenn einem symbolischen Link gefolgt werden soll
+ *
+ * \func stat() liest die Metadaten des Ziels eines Links
+ * \func lstat() liest die Metadaten ohne einem Link zu folgen
+ *
+ * \return 0 wenn erfolgreich, sonst -1 und errno ist gesetzt
+ */
+static int stat_entry(const char *file_name, struct stat *file_stat, bool follow) {
+    if (!follow)
+        return lstat(file_name, file_stat);
+
+    if (stat(file_name, file_stat) == 0)
+        return 0;
+    if (errno != ENOENT)
+        return -1;
+
+    // dangling link
+    errno = 0;
+    return lstat(file_name, file_stat);
+}
+
+/**
+ * \brief Diese Funktion öffnet ein Directory und legt es auf den Stack der Traversierung.
+ *
+ * Die Einträge werden danach von do_next() gelesen. Ist inode_order oder sort_name gesetzt,
+ * werden die Einträge von do_dir_sorted() vorher gepuffert.
+ *
+ * \param iter der Iterator der Traversierung
+ * \param paramc context-struct des zu verarbeitenden Verzeichnisses
+ *
+ * \func throttle_dir() wartet mit --max-dir-rate bzw. --backoff-latency vor dem Lesen des Verzeichnisses.
+ * \func opendir() öffnet einen Directory-Stream um die Elemente des Directorys zu laden.
+ * \func push_frame() legt das Verzeichnis auf den Stack.
+ * \func prefetch_opened() gibt dem Hilfs-Thread zum Vorauslesen ein weiteres Verzeichnis frei.
+ * \func closedir() schließt den Diretory-Stream wieder, wenn er nicht gespeichert werden kann.
+ *
+ * \return einen Statuscode der Auskunft über mögliche Fehler bei der Verarbeitung gibt
+ */
+static retval_t do_dir(myfind_iter_t *iter, const param_context_t *paramc) {
+    const myfind_options_t *options = &iter->expr->options;
+    const char *dir_name = paramc->file_name;
+    frame_t *frame;
+    retval_t result;
+
+    debug_print("DEBUG: do_dir '%s'\n", dir_name);
+
+    int64_t start = throttle_dir(&iter->expr->throttle);
+    DIR *dirp = opendir(dir_name);
+    if (dirp == NULL) {
+        // mostly because we are not allowed to, so no error-propagation needed
+        error(ERR_NONCRITICAL, errno, "can't open dir '%s'", dir_name);
+        errno = 0;
+        return OK_NOERROR;
+    }
+
+    if ((result = push_frame(iter, dir_name, paramc->file_stat, &frame)) != OK_NOERROR) {
+        (void)closedir(dirp);
+        return result;
+    }
+    frame->du_dir = paramc->dir;
+
+    if (iter->prefetch != NULL)
+        prefetch_opened(iter->prefetch);
+
+    if (options->inode_order || options->sort_name) {
+        // entries are buffered, so the stream is already closed after this call
+        result = do_dir_sorted(iter, frame, dirp);
+        throttle_dir_done(&iter->expr->throttle, throttle_clock(&iter->expr->throttle) - start);
+    } else {
+        // the time of the readdir() calls is added in do_next() up to the end of the directory
+        frame->dirp = dirp;
+        frame->read_time = throttle_clock(&iter->expr->throttle) - start;
+    }
+
+    debug_print("DEBUG: ended do_dir with '%d' \n", result);
+    return result;
+}
+
+/**
+ * \brief Puffert die Einträge eines Directorys für die sortierte Verarbeitung.
+ *
+ * Es werden zuerst alle Einträge gelesen und der Directory-Stream geschlossen. Mit inode_order werden
+ * die Einträge danach nach d_ino sortiert und in dieser Reihenfolge mit lstat() gelesen, damit die
+ * Inode-Tabelle möglichst sequentiell von der Platte gelesen wird (wie bei fts-basierten Tools).
+ * Mit sort_name werden die Einträge anschließend nach Namen sortiert verarbeitet, wodurch die
+ * Ausgabe ohne externes 'sort' in einer stabilen Reihenfolge erfolgt.
+ *
+ * \param iter der Iterator der Traversierung
+ * \param frame der Frame des Verzeichnisses, erhält die gepufferten Einträge
+ * \param dirp bereits geöffneter Directory-Stream, wird von dieser Funktion geschlossen
+ *
+ * \func read_dir_entries() liest alle Einträge des Directorys in ein Array.
+ * \func stat_dir_entries() liest die Metadaten aller Einträge in Array-Reihenfolge.
+ * \func qsort() sortiert die Einträge nach Inode bzw. Namen.
+ *
+ * \return einen Statuscode der Auskunft über mögliche Fehler bei der Verarbeitung gibt
+ */
+static retval_t do_dir_sorted(myfind_iter_t *iter, frame_t *frame, DIR *dirp) {
+    const myfind_options_t *options = &iter->expr->options;
+    retval_t result = read_dir_entries(frame->path, dirp, &frame->entries, &frame->count);
+
+    // don't panic on this, cause we can't do anything against it at this point
+    if (closedir(dirp) == -1) {
+        error(ERR_NONCRITICAL, errno, "faild to close dir '%s'", frame->path);
+        errno = 0;
+    }
+
+    if (result != OK_NOERROR)
+        return result;
+
+    if (options->inode_order) {
+        qsort(frame->entries, frame->count, sizeof(dir_entry_t), compare_entry_ino);
+        stat_dir_entries(frame->path, frame->entries, frame->count, options->follow == FOLLOW_ALWAYS);
+    }
+
+    if (options->sort_name)
+        qsort(frame->entries, frame->count, sizeof(dir_entry_t), compare_entry_name);
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Legt ein neues Verzeichnis auf den Stack der Traversierung.
+ *
+ * \param iter der Iterator der Traversierung
+ * \param dir_name Pfad des Verzeichnisses
+ * \param dir_stat metadaten des Verzeichnisses
+ * \param frame Ausgabe-Pointer für den neuen Frame, gültig bis zum nächsten push_frame()
+ *
+ * \func devino_insert() merkt sich das Verzeichnis für die Erkennung von Schleifen, wenn Links gefolgt wird
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t push_frame(myfind_iter_t *iter, const char *dir_name, const struct stat *dir_stat, frame_t **frame) {
+    if (iter->depth == iter->capacity) {
+        size_t capacity = (iter->capacity == 0) ? FRAMES_INITIAL : iter->capacity * 2;
+        frame_t *tmp = realloc(iter->frames, capacity * sizeof(frame_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        iter->frames = tmp;
+        iter->capacity = capacity;
+    }
+
+    if (iter->expr->options.follow != FOLLOW_NEVER &&
+        devino_insert(&iter->ancestors, dir_stat->st_dev, dir_stat->st_ino) == ERR_OUT_OF_MEMORY)
+        return ERR_OUT_OF_MEMORY;
+
+    *frame = &iter->frames[iter->depth];
+    memset(*frame, 0, sizeof(frame_t));
+    (*frame)->dev = dir_stat->st_dev;
+    (*frame)->ino = dir_stat->st_ino;
+    if (((*frame)->path = strdup(dir_name)) == NULL) {
+        devino_remove(&iter->ancestors, dir_stat->st_dev, dir_stat->st_ino);
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    iter->depth++;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Nimmt das oberste Verzeichnis vom Stack der Traversierung und gibt es frei.
+ *
+ * \param iter der Iterator der Traversierung
+ */
+static void pop_frame(myfind_iter_t *iter) {
+    frame_t *frame = &iter->frames[--iter->depth];
+
+    // don't panic on this, cause we can't do anything against it at this point
+    if (frame->dirp != NULL && closedir(frame->dirp) == -1) {
+        error(ERR_NONCRITICAL, errno, "faild to close dir '%s'", frame->path);
+        errno = 0;
+    }
+
+    if (iter->expr->options.follow != FOLLOW_NEVER)
+        devino_remove(&iter->ancestors, frame->dev, frame->ino);
+
+    free_dir_entries(frame->entries, frame->count);
+    free(frame->path);
+}
+
+/**
+ * \brief Liest alle Einträge (außer "." und "..") eines Directory-Streams in ein dynamisches Array.
+ *
+ * \param dir_name Name des Verzeichnisses (für Fehlermeldungen)
+ * \param dirp geöffneter Directory-Stream
+ * \param entries Ausgabe-Pointer für das allokierte Array. Muss mit free_dir_entries() freigegeben werden.
+ * \param count Ausgabe-Pointer für die Anzahl der gelesenen Einträge
+ *
+ * \func readdir() liefert einen Pointer zu einem "struct dirent" der den Eintrag beschreibt.
+ * \func realloc() vergrößert das Array bei Bedarf.
+ *
+ * \return OK_NOERROR wenn erfolgreich, ERR_OUT_OF_MEMORY wenn nicht genug Speicher vorhanden ist
+ */
+static retval_t read_dir_entries(const char *dir_name, DIR *dirp, dir_entry_t **entries, size_t *count) {
+    struct dirent *dp;
+    size_t capacity = 0;
+
+    *entries = NULL;
+    *count = 0;
+
+    for (errno = 0; ((dp = readdir(dirp)) != NULL) || errno != 0; errno = 0) {
+        // if readdir throws an error, print it and stop reading
+        if (dp == NULL) {
+            error(ERR_NONCRITICAL, errno, "can't read dir '%s'", dir_name);
+            errno = 0;
+            break;
+        }
+
+        // leave "." and ".." links alone
+        if (strcmp(dp->d_name, ".") == 0 || strcmp(dp->d_name, "..") == 0)
+            continue;
+
+        if (*count == capacity) {
+            capacity = (capacity == 0) ? DIR_ENTRIES_INITIAL : capacity * 2;
+            dir_entry_t *tmp = realloc(*entries, capacity * sizeof(dir_entry_t));
+            if (tmp == NULL) {
+                free_dir_entries(*entries, *count);
+                *entries = NULL;
+                *count = 0;
+                return ERR_OUT_OF_MEMORY;
+            }
+            *entries = tmp;
+        }
+
+        dir_entry_t *entry = &(*entries)[*count];
+        entry->name = strdup(dp->d_name);
+        entry->ino = dp->d_ino;
+        entry->stat_errno = -1;
+        if (entry->name == NULL) {
+            free_dir_entries(*entries, *count);
+            *entries = NULL;
+            *count = 0;
+            return ERR_OUT_OF_MEMORY;
+        }
+        (*count)++;
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Liest die Metadaten aller Einträge in Array-Reihenfolge mit stat_entry().
+ *
+ * Fehler werden im Eintrag vermerkt und erst bei der Verarbeitung ausgegeben,
+ * damit die Fehlermeldungen in Verarbeitungs-Reihenfolge erscheinen.
+ *
+ * \param dir_name Name des Verzeichnisses in dem sich die Einträge befinden
+ * \param entries Array der zu lesenden Einträge
+ * \param count Anzahl der Einträge
+ * \param follow true wenn symbolischen Links gefolgt werden soll (-L)
+ */
+static void stat_dir_entries(const char *dir_name, dir_entry_t *entries, size_t count, bool follow) {
+    for (size_t i = 0; i < count; i++) {
+        size_t pathsize = strlen(dir_name) + strlen(entries[i].name) + 2; // lengths + '/' + \0
+        char path[pathsize];
+        snprintf(path, pathsize, "%s/%s", dir_name, entries[i].name);
+
+        errno = 0;
+        entries[i].stat_errno = (stat_entry(path, &entries[i].stat, follow) == -1) ? errno : 0;
+        errno = 0;
+    }
+}
+
+/**
+ * \brief Gibt ein von read_dir_entries() allokiertes Array inklusive der Namen frei.
+ *
+ * \param entries freizugebendes Array (kann NULL sein)
+ * \param count Anzahl der Einträge
+ */
+static void free_dir_entries(dir_entry_t *entries, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        free(entries[i].name);
+    free(entries);
+}
+
+/**
+ * \brief Vergleichsfunktion für qsort() nach Inode-Nummer
+ */
+static int compare_entry_ino(const void *a, const void *b) {
+    ino_t ino_a = ((const dir_entry_t *)a)->ino;
+    ino_t ino_b = ((const dir_entry_t *)b)->ino;
+    return (ino_a > ino_b) - (ino_a < ino_b);
+}
+
+/**
+ * \brief Vergleichsfunktion für qsort() nach Name (Byte-Reihenfolge, wie 'LC_ALL=C sort')
+ */
+static int compare_entry_name(const void *a, const void *b) {
+    return strcmp(((const dir_entry_t *)a)->name, ((const dir_entry_t *)b)->name);
+}
+
+/**
+ * \brief Übersetzt die Expression-Argumente einmalig in ein Array von param_t.
+ *
+ * Jedes Argument wird mit get_param() analysiert und danach mit compile_param() vorberechnet.
+ * Fehler werden hier bereits mit handle_error() ausgegeben.
+ *
+ * \param parms die angegebenen Argumente (NULL-terminiert)
+ * \param expr Ausgabe-Pointer für die übersetzte Expression. Muss mit free_params() freigegeben werden.
+ *
+ * \func get_param() Analysiert die Usereingabe und gibt ein struct zurück
+ * \func compile_param() Berechnet die Vergleichswerte des Parameters vor
+ * \func handle_error() Errorhandling.
+ *
+ * \return OK_NOERROR wenn erfolgreich oder einen negativen Error-Code im Fehlerfall
+ */
+static retval_t compile_params(const char *const *parms, expression_t *expr) {
+    const char *command = NULL;
+    size_t argc = 0;
+    int i = 0;
+    retval_t result = OK_NOERROR;
+    param_t param = {INVALID, NULL, 0, 0, 0, NULL, NULL, NULL, NULL, NULL, NULL};
+    struct timespec now;
+
+    expr->count = 0;
+    expr->has_action = false;
+    clock_gettime(CLOCK_REALTIME, &now);
+    expr->now = timespec_to_ns(&now);
+
+    // every param consumes at least one argument, so argc is an upper bound
+    while (parms[argc] != NULL)
+        argc++;
+
+    expr->params = calloc(argc + 1, sizeof(param_t));
+    if (expr->params == NULL) {
+        handle_error(&param, ERR_OUT_OF_MEMORY);
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    // save current param to command and increment counter
+    while ((command = parms[i++]) != NULL) {
+        // analyze parameter
+        param.value = NULL;
+        param.exec = NULL;
+        param.dupes = NULL;
+        param.du = NULL;
+        param.names = NULL;
+        param.regex = NULL;
+        param.hits = NULL;
+        result = get_param(command, parms[i], &param);
+        if (result < 0)
+            break;
+        else if (result == OK_VALUE_EXISTS)
+            i++; // skip value and got to next argument
+
+        // precalculate parameter, -exec consumes all arguments up to its terminator
+        if (param.opt == EXEC)
+            result = compile_param_exec(&param, parms, &i, &expr->pool);
+        else if (param.opt == DU)
+            result = compile_param_du(&param, expr);
+        else
+            result = compile_param(&param, expr);
+        if (result < 0)
+            break;
+
+        // user and group names are resolved once per expression, even across several start directories
+        if (param.opt == LS || param.opt == NOUSER)
+            param.names = &expr->names;
+
+        // -quit is an action like in find, -limit passes the files on and keeps the implicit -print
+        if (param.opt == LS || param.opt == PRINT || param.opt == EXEC || param.opt == DUPES || param.opt == DU ||
+            param.opt == QUIT)
+            expr->has_action = true;
+
+        expr->params[expr->count++] = param;
+    }
+
+    if (result < 0) {
+        handle_error(&param, result);
+        free(param.value);
+        return result;
+    }
+
+    reorder_params(expr);
+
+    // a ';' command at the end of the expression does not influence any result, so it may run asynchronously
+    if (expr->count > 0 && expr->params[expr->count - 1].opt == EXEC)
+        expr->params[expr->count - 1].exec->async = true;
+
+    debug_print("DEBUG: compiled %lu params\n", (unsigned long)expr->count);
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Berechnet die Vergleichswerte eines Parameters vor und prüft dessen Gültigkeit.
+ *
+ * \param param parameter-struct das vorberechnet werden soll
+ * \param expr die Expression zu der der Parameter gehört (Startzeitpunkt, Optionen)
+ *
+ * \return OK_NOERROR wenn erfolgreich oder einen negativen Error-Code im Fehlerfall
+ */
+static retval_t compile_param(param_t *param, const expression_t *expr) {
+    int64_t now = expr->now;
+
+    switch (param->opt) {
+    case USER:
+        return compile_param_user(param);
+    case TYPE:
+        return compile_param_type(param);
+    case SIZE:
+        return compile_param_size(param);
+    case MTIME:
+        return compile_param_time(param, now, SECONDS_PER_DAY, false);
+    case MMIN:
+        return compile_param_time(param, now, SECONDS_PER_MINUTE, true);
+    case NEWER:
+        return compile_param_newer(param, expr->options.follow);
+    case CONTAINS:
+        // max is the size guard, min the length of the string to search
+        param->min = (int64_t)strlen(param->value);
+        param->max = (expr->options.content_max > 0) ? expr->options.content_max : INT64_MAX;
+        return OK_NOERROR;
+    case DUPES:
+        if ((param->dupes = calloc(1, sizeof(dupes_t))) == NULL)
+            return ERR_OUT_OF_MEMORY;
+        param->dupes->all_links = (expr->options.follow != FOLLOW_NEVER);
+        return OK_NOERROR;
+    case REGEX:
+    case IREGEX:
+        return compile_param_regex(param, param->opt == IREGEX);
+    case LIMIT:
+        return compile_param_limit(param);
+    default:
+        // nothing to precalculate
+        return OK_NOERROR;
+    }
+}
+
+/**
+ * \brief Löst den Benutzer des -user Arguments einmalig auf
+ *
+ * Versucht einen gültigen Benutzer aus dem angegebenen Zusatz über die passwd aufzulösen.
+ * Gelingt dies nicht wird versucht den Zusatz als UserId zu lesen.
+ * Schlagen alle Versuche fehl wird ein Fehler zurückgegeben.
+ *
+ * \param param parameter-struct des -user Arguments
+ *
+ * \func getpwnam() Sucht einen Eintrag mit einem passenden Usernamen
+ * \func strtoul() Konvertiert einen String zu einen unsigned long integer
+ *
+ * \return OK_NOERROR oder ERR_NO_USER_FOUND wenn der Benutzer nicht aufgelöst werden kann
+ */
+static retval_t compile_param_user(param_t *param) {
+    char *tmp;
+
+    debug_print("DEBUG: resolving user '%s'\n", param->value);
+
+    errno = 0;
+    struct passwd *usr = getpwnam(param->value);
+
+    // no user in passwd, check if userid is given
+    if (usr == NULL) {
+        param->uid = strtoul(param->value, &tmp, 0);
+
+        // no username nor userid => error
+        if (*tmp != '\0')
+            return ERR_NO_USER_FOUND;
+    } else {
+        // user found in passwd -> prepare uid for check
+        param->uid = usr->pw_uid;
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Prüft ob der Wert des -type Arguments einem validen Type entspricht.
+ *
+ * Ist die Eingabe nicht genau eines dieser Zeichen: "bcdpfls" wird ein Errorcode geliefert.
+ *
+ * \param param parameter-struct des -type Arguments
+ *
+ * \return OK_NOERROR oder ERR_INVALID_TYPE_ARGUMENT
+ */
+static retval_t compile_param_type(const param_t *param) {
+    if (strlen(param->value) != 1 || strchr("bcdpfls", param->value[0]) == NULL)
+        return ERR_INVALID_TYPE_ARGUMENT;
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Berechnet die Grenzen des -size Arguments in Bytes vor.
+ *
+ * Wie bei GNU find wird die Dateigröße auf ganze Einheiten aufgerundet, bevor sie mit n verglichen wird.
+ * Einheiten: b = 512 Byte (Standard), c = Byte, w = 2 Byte, k = KiB, M = MiB, G = GiB.
+ * Daraus ergibt sich für st_size:
+ *   +n => st_size >  n * unit
+ *   -n => st_size <= (n - 1) * unit
+ *    n => (n - 1) * unit < st_size <= n * unit
+ *
+ * \param param parameter-struct des -size Arguments
+ *
+ * \return OK_NOERROR oder ERR_INVALID_NUMBER bei ungültiger Zahl oder Einheit
+ */
+static retval_t compile_param_size(param_t *param) {
+    const char *suffix;
+    char cmp;
+    int64_t n;
+    int64_t unit;
+
+    if (parse_number(param->value, &cmp, &n, &suffix) != OK_NOERROR ||
+        parse_unit(suffix, SIZE_UNIT_BLOCK, &unit) != OK_NOERROR || n > INT64_MAX / unit - 1)
+        return ERR_INVALID_NUMBER;
+
+    param->min = (cmp == '+') ? n * unit + 1 : (cmp == '-') ? INT64_MIN : (n - 1) * unit + 1;
+    param->max = (cmp == '+') ? INT64_MAX : (cmp == '-') ? (n - 1) * unit : n * unit;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Berechnet die Grenzen des -mtime bzw. -mmin Arguments als absolute Zeitpunkte in Nanosekunden vor.
+ *
+ * Die Grenzen entsprechen denen von GNU find. Bei -mtime wird das Alter in ganzen Tagen abgerundet,
+ * bei -mmin in ganzen Minuten aufgerundet (round_up):
+ *   -mtime +n => age >= (n + 1) * period     -mmin +n => age >  n * period
+ *   -mtime -n => age <  n * period           -mmin -n => age <  n * period
+ *   -mtime  n => n * period <= age < (n + 1) * period
+ *   -mmin   n => (n - 1) * period < age <= n * period
+ * Mit age = now - st_mtime ergeben sich daraus die Grenzen für st_mtime.
+ *
+ * \param param parameter-struct des -mtime/-mmin Arguments
+ * \param now Startzeitpunkt in Nanosekunden
+ * \param period Länge einer Periode in Sekunden (Tag bzw. Minute)
+ * \param round_up true wenn das Alter auf ganze Perioden aufgerundet wird
+ *
+ * \return OK_NOERROR oder ERR_INVALID_NUMBER bei ungültiger Zahl
+ */
+static retval_t compile_param_time(param_t *param, int64_t now, int64_t period, bool round_up) {
+    const char *suffix;
+    char cmp;
+    int64_t n;
+
+    period *= NSEC_PER_SEC;
+    if (parse_number(param->value, &cmp, &n, &suffix) != OK_NOERROR || *suffix != '\0' ||
+        n > INT64_MAX / period - 2)
+        return ERR_INVALID_NUMBER;
+
+    // border between the (n-1)th/nth period (round_up) or the nth/(n+1)th period
+    int64_t edge = now - (round_up ? n : n + 1) * period;
+
+    switch (cmp) {
+    case '+':
+        param->min = INT64_MIN;
+        param->max = round_up ? edge - 1 : edge;
+        break;
+    case '-':
+        param->min = now - n * period + 1;
+        param->max = INT64_MAX;
+        break;
+    default:
+        param->min = round_up ? edge : edge + 1;
+        param->max = round_up ? edge + period - 1 : edge + period;
+        break;
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Liest die Änderungszeit der Referenz-Datei des -newer Arguments einmalig.
+ *
+ * Die Zeit wird wie bei -mtime in Nanosekunden gespeichert, damit pro Datei nur ein Integer-Vergleich nötig ist.
+ *
+ * \param param parameter-struct des -newer Arguments
+ * \param follow welchen symbolischen Links gefolgt wird, wie bei find gilt -H auch für die Referenz-Datei
+ *
+ * \func stat_entry() ließt die Attribute der Referenz-Datei aus, mit -H und -L die des Link-Ziels
+ *
+ * \return OK_NOERROR oder ERR_NO_REFERENCE_FILE wenn die Datei nicht gelesen werden kann
+ */
+static retval_t compile_param_newer(param_t *param, follow_t follow) {
+    struct stat ref;
+
+    errno = 0;
+    if (stat_entry(param->value, &ref, follow != FOLLOW_NEVER) == -1)
+        return ERR_NO_REFERENCE_FILE;
+
+    param->min = timespec_to_ns(&ref.st_mtim) + 1;
+    param->max = INT64_MAX;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Übersetzt ein -exec Argument.
+ *
+ * Das Kommando (param->value) und alle folgenden Argumente bis zum abschließenden ';' bzw. '{} +'
+ * werden als Vorlage gespeichert. Für '{} +' wird zusätzlich die maximale argv-Größe laut ARG_MAX
+ * abzüglich des Environments berechnet.
+ *
+ * \param param parameter-struct des -exec Arguments, value enthält das Kommando
+ * \param parms die angegebenen Argumente (NULL-terminiert)
+ * \param i Index des ersten Arguments nach dem Kommando, zeigt danach hinter das Ende-Zeichen
+ * \param pool gemeinsamer Prozess-Pool
+ *
+ * \func sysconf() liefert ARG_MAX
+ *
+ * \return OK_NOERROR, ERR_VALUE_MISSING wenn das Ende-Zeichen fehlt, ERR_INVALID_ARGUMENT wenn bei '{} +'
+ *         ein weiteres '{}' vorkommt oder das Kommando neben dem Environment nicht in ARG_MAX passt,
+ *         ERR_OUT_OF_MEMORY
+ */
+static retval_t compile_param_exec(param_t *param, const char *const *parms, int *i, exec_pool_t *pool) {
+    int end = *i;
+    bool batch = false;
+
+    // search terminator, '+' only terminates directly after an argument containing '{}' (like find)
+    while (parms[end] != NULL && strcmp(parms[end], ";") != 0 &&
+           !(end > *i && strcmp(parms[end], "+") == 0 && strstr(parms[end - 1], EXEC_PLACEHOLDER) != NULL))
+        end++;
+
+    if (parms[end] == NULL || strcmp(param->value, ";") == 0)
+        return ERR_VALUE_MISSING;
+    batch = (parms[end][0] == '+');
+
+    if (batch && strcmp(parms[end - 1], EXEC_PLACEHOLDER) != 0) {
+        error(0, 0, "in '-exec ... {} +' the '{}' must appear by itself, but you specified '%s'", parms[end - 1]);
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    // like find, '{} +' allows only the one '{}' that is replaced by the paths
+    bool extra = batch && strstr(param->value, EXEC_PLACEHOLDER) != NULL;
+    for (int j = *i; batch && j < end - 1; j++)
+        extra = extra || strstr(parms[j], EXEC_PLACEHOLDER) != NULL;
+    if (extra) {
+        error(0, 0, "only one instance of {} is supported with -exec ... +");
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    exec_t *exec = calloc(1, sizeof(exec_t));
+    size_t argc = 1 + (size_t)(end - *i) - (batch ? 1 : 0);
+    const char **argv = calloc(argc + 1, sizeof(char *));
+    if (exec == NULL || argv == NULL) {
+        free(exec);
+        free(argv);
+        return ERR_OUT_OF_MEMORY;
+    }
+    param->exec = exec;
+
+    exec->pool = pool;
+    exec->batch = batch;
+    exec->argc = argc;
+    exec->argv = argv;
+
+    exec->argv[0] = param->value;
+    for (size_t j = 1; j < exec->argc; j++)
+        exec->argv[j] = parms[*i + (int)j - 1];
+
+    if (batch) {
+        long arg_max = sysconf(_SC_ARG_MAX);
+        size_t env_size = 0;
+
+        for (char **env = environ; *env != NULL; env++)
+            env_size += strlen(*env) + 1 + sizeof(char *);
+
+        size_t limit = (arg_max > 0) ? (size_t)arg_max : (size_t)_POSIX_ARG_MAX;
+        for (size_t j = 0; j <= exec->argc; j++)
+            exec->size += sizeof(char *) + (exec->argv[j] != NULL ? strlen(exec->argv[j]) + 1 : 0);
+
+        // like find, give up if not even the command itself fits next to the environment
+        if (env_size + EXEC_ARG_MAX_RESERVE + exec->size >= limit) {
+            error(0, 0, "the environment is too large for '-exec ... {} +'");
+            return ERR_INVALID_ARGUMENT;
+        }
+        exec->size_max = limit - env_size - EXEC_ARG_MAX_RESERVE;
+    }
+
+    debug_print("DEBUG: compiled -exec '%s' with %lu args (batch=%d)\n", param->value, (unsigned long)exec->argc,
+                batch);
+
+    *i = end + 1;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Übersetzt ein -du Argument.
+ *
+ * Alle -du Argumente einer Expression zählen in dieselbe Verzeichnis-Tabelle, da die Verzeichnisse von der
+ * Traversierung und nicht vom Argument eingetragen werden (siehe do_entry()).
+ *
+ * \param param parameter-struct des -du Arguments
+ * \param expr die Expression, erhält die Verzeichnis-Tabelle
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t compile_param_du(param_t *param, expression_t *expr) {
+    if (expr->du == NULL) {
+        if ((expr->du = calloc(1, sizeof(du_t))) == NULL)
+            return ERR_OUT_OF_MEMORY;
+        expr->du->all_links = (expr->options.follow != FOLLOW_NEVER);
+    }
+
+    param->du = expr->du;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Übersetzt das Pattern eines -regex oder -iregex Arguments.
+ *
+ * Das Pattern ist eine POSIX Extended Regular Expression, die wie bei find auf den ganzen Pfad passen muss.
+ * Es wird zuerst in einen Syntaxbaum gelesen und daraus ein NFA erstellt (Thompson-Konstruktion).
+ * Der DFA entsteht erst während der Traversierung (siehe rx_match()).
+ *
+ * \param param parameter-struct des Arguments, erhält das übersetzte Pattern
+ * \param icase Groß- und Kleinschreibung nicht unterscheiden
+ *
+ * \func rx_parse_alt() liest das Pattern
+ * \func rx_emit() erstellt den NFA aus dem Syntaxbaum
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN oder ERR_OUT_OF_MEMORY
+ */
+static retval_t compile_param_regex(param_t *param, bool icase) {
+    rx_parser_t parser = {param->value, icase, 0, NULL, 0, 0, NULL};
+    uint32_t match = 0;
+    size_t root = RX_NONE;
+
+    rx_t *rx = calloc(1, sizeof(rx_t));
+    if (rx == NULL)
+        return ERR_OUT_OF_MEMORY;
+    parser.rx = rx;
+
+    // the NFA is built backwards, starting with the final state
+    retval_t result = rx_new_state(rx, RX_MATCH, 0, 0, &match);
+    if (result == OK_NOERROR)
+        result = rx_parse_alt(&parser, &root);
+    // only a ')' without '(' stops the parser before the end
+    if (result == OK_NOERROR && *parser.pos != '\0')
+        result = ERR_INVALID_PATTERN;
+    if (result == OK_NOERROR)
+        result = rx_emit(rx, parser.nodes, root, match, &rx->root);
+    free(parser.nodes);
+
+    if (result == OK_NOERROR) {
+        rx->mark = calloc(rx->nfa_count, sizeof(uint32_t));
+        rx->stack = malloc((2 * rx->nfa_count + 1) * sizeof(uint32_t));
+        rx->work = malloc(rx->nfa_count * sizeof(uint32_t));
+        rx->scratch = malloc(rx->nfa_count * sizeof(uint32_t));
+        rx->table = malloc(2 * RX_DFA_MAX * sizeof(int32_t));
+        if (rx->mark == NULL || rx->stack == NULL || rx->work == NULL || rx->scratch == NULL || rx->table == NULL)
+            result = ERR_OUT_OF_MEMORY;
+    }
+
+    if (result != OK_NOERROR) {
+        rx_free(rx);
+        return result;
+    }
+
+    memset(rx->table, 0xff, 2 * RX_DFA_MAX * sizeof(int32_t));
+    rx->start = RX_UNKNOWN;
+    param->regex = rx;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Übersetzt ein -limit Argument.
+ *
+ * \param param parameter-struct des -limit Arguments, erhält das Limit in min und den Zähler
+ *
+ * \func parse_number() liest die Anzahl, sie muss ohne Vorzeichen und Einheit angegeben werden
+ *
+ * \return OK_NOERROR, ERR_INVALID_NUMBER wenn die Anzahl kleiner als 1 ist oder ERR_OUT_OF_MEMORY
+ */
+static retval_t compile_param_limit(param_t *param) {
+    const char *suffix;
+    char cmp;
+
+    if (parse_number(param->value, &cmp, &param->min, &suffix) != OK_NOERROR || cmp != '=' || *suffix != '\0' ||
+        param->min < 1)
+        return ERR_INVALID_NUMBER;
+
+    if ((param->hits = calloc(1, sizeof(int64_t))) == NULL)
+        return ERR_OUT_OF_MEMORY;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Liest eine Zahl im find-Format "[+-]n" gefolgt von einem optionalen Suffix.
+ *
+ * \param value zu lesende Zeichenkette
+ * \param cmp Ausgabe-Pointer für den Vergleichsoperator ('+', '-' oder '=')
+ * \param num Ausgabe-Pointer für die gelesene Zahl (>= 0)
+ * \param suffix Ausgabe-Pointer auf das erste Zeichen nach der Zahl
+ *
+ * \func strtoll() Konvertiert einen String zu einem long long integer
+ *
+ * \return OK_NOERROR oder ERR_INVALID_NUMBER
+ */
+static retval_t parse_number(const char *value, char *cmp, int64_t *num, const char **suffix) {
+    char *end;
+
+    *cmp = '=';
+    if (value[0] == '+' || value[0] == '-')
+        *cmp = *value++;
+
+    // strtoll would accept whitespace and another sign
+    if (value[0] < '0' || value[0] > '9')
+        return ERR_INVALID_NUMBER;
+
+    errno = 0;
+    long long n = strtoll(value, &end, 10);
+    if (errno != 0) {
+        errno = 0;
+        return ERR_INVALID_NUMBER;
+    }
+
+    *num = n;
+    *suffix = end;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Schließt die Verarbeitung der Expression nach der Traversierung ab.
+ *
+ * Es wird auf alle Dateien im Thread-Pool von -contains gewartet, danach werden noch gesammelte Pfade von
+ * -exec ... {} + ausgeführt und auf alle laufenden Kommandos gewartet. Zuletzt werden die Duplikate
+ * der -dupes Argumente und die Verzeichnis-Summen von -du ausgegeben.
+ *
+ * \param expr die übersetzte Expression
+ *
+ * \func content_drain() wartet auf den Thread-Pool von -contains
+ * \func exec_flush() startet die restlichen Sammel-Ausführungen
+ * \func exec_wait() wartet auf alle asynchron gestarteten Prozesse
+ * \func dupes_report() sucht und gibt die Duplikate aus
+ * \func du_report() summiert und gibt die Verzeichnisse aus
+ *
+ * \return OK_NOERROR, ERR_EXEC_FAILED wenn ein -exec ... + Kommando fehlgeschlagen ist, ERR_OUT_OF_MEMORY
+ *         oder den Fehler der Auswertung einer von -contains gefundenen Datei bzw. der Ausgabe von -dupes oder -du
+ */
+static retval_t finish_params(expression_t *expr) {
+    // files found by -contains may still start -exec commands
+    retval_t result = content_drain(expr->content, true);
+
+    for (size_t i = 0; i < expr->count; i++) {
+        if (expr->params[i].opt == EXEC && expr->params[i].exec->batch) {
+            retval_t flushed = exec_flush(expr->params[i].exec);
+            if (flushed < 0 && result == OK_NOERROR)
+                result = flushed;
+        }
+    }
+
+    exec_wait(&expr->pool, 0);
+    for (size_t i = 0; i < expr->count; i++) {
+        // the next traversal with this expression starts over
+        if (expr->params[i].opt == LIMIT)
+            *expr->params[i].hits = 0;
+    }
+    if (result == OK_NOERROR && expr->pool.failed)
+        result = ERR_EXEC_FAILED;
+    expr->pool.failed = false;
+
+    for (size_t i = 0; i < expr->count && result == OK_NOERROR; i++) {
+        if (expr->params[i].opt != DUPES)
+            continue;
+
+        if ((result = dupes_report(expr->params[i].dupes, expr->options.jobs)) < 0)
+            handle_error(&expr->params[i], result);
+
+        // the next traversal with this expression starts over
+        clear_dupes(expr->params[i].dupes);
+    }
+
+    // all -du arguments share one table, it is reported once with the first of them
+    for (size_t i = 0; i < expr->count && expr->du != NULL; i++) {
+        if (expr->params[i].opt != DU)
+            continue;
+
+        if (result == OK_NOERROR && (result = du_report(expr->du, expr->options.du_depth)) < 0)
+            handle_error(&expr->params[i], result);
+
+        clear_du(expr->du);
+        break;
+    }
+
+    return result;
+}
+
+/**
+ * \brief Verschiebt teure Parameter hinter die billigen Filter.
+ *
+ * Die Filter ohne Seiteneffekte sind untereinander vertauschbar, da alle Parameter mit UND verknüpft sind.
+ * -contains wird daher bis zur nächsten Ausgabe-Option bzw. zum Ende nach hinten verschoben,
+ * damit Dateien nur gelesen werden, wenn alle anderen Filter bereits zutreffen.
+ *
+ * \param expr die übersetzte Expression
+ */
+static void reorder_params(expression_t *expr) {
+    for (size_t i = expr->count; i-- > 0;) {
+        if (expr->params[i].opt != CONTAINS)
+            continue;
+
+        for (size_t j = i; j + 1 < expr->count && is_predicate(expr->params[j + 1].opt); j++) {
+            param_t tmp = expr->params[j];
+            expr->params[j] = expr->params[j + 1];
+            expr->params[j + 1] = tmp;
+        }
+    }
+}
+
+/**
+ * \brief Prüft ob eine Option ein billiger Filter ohne Seiteneffekte ist, der nur die stat-Daten oder den Pfad prüft.
+ *
+ * \param opt zu prüfende Option
+ *
+ * \return true für billige Filter
+ */
+static bool is_predicate(opt_t opt) {
+    switch (opt) {
+    case USER:
+    case NAME:
+    case TYPE:
+    case NOUSER:
+    case PATH:
+    case SIZE:
+    case MTIME:
+    case MMIN:
+    case NEWER:
+    case REGEX:
+    case IREGEX:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * \brief Liest eine Größen-Einheit wie bei -size.
+ *
+ * Einheiten: b = 512 Byte, c = Byte, w = 2 Byte, k = KiB, M = MiB, G = GiB.
+ *
+ * \param suffix zu lesende Einheit, muss nach dem Zeichen enden
+ * \param default_unit Einheit in Bytes die ohne Angabe verwendet wird
+ * \param unit Ausgabe-Pointer für die Einheit in Bytes
+ *
+ * \return OK_NOERROR oder ERR_INVALID_NUMBER
+ */
+static retval_t parse_unit(const char *suffix, int64_t default_unit, int64_t *unit) {
+    switch (*suffix) {
+    case '\0':
+        *unit = default_unit;
+        return OK_NOERROR;
+    case 'b':
+        *unit = SIZE_UNIT_BLOCK;
+        break;
+    case 'c':
+        *unit = 1;
+        break;
+    case 'w':
+        *unit = 2;
+        break;
+    case 'k':
+        *unit = 1024;
+        break;
+    case 'M':
+        *unit = 1024 * 1024;
+        break;
+    case 'G':
+        *unit = 1024 * 1024 * 1024;
+        break;
+    default:
+        return ERR_INVALID_NUMBER;
+    }
+
+    return (suffix[1] == '\0') ? OK_NOERROR : ERR_INVALID_NUMBER;
+}
+
+/**
+ * \brief Gibt die von compile_params() allokierten Daten frei.
+ *
+ * \param expr freizugebende Expression
+ */
+static void free_params(expression_t *expr) {
+    content_stop(expr->content);
+    expr->content = NULL;
+    free(expr->content_buffer);
+    expr->content_buffer = NULL;
+
+    for (size_t i = 0; i < expr->count; i++) {
+        exec_t *exec = expr->params[i].exec;
+        if (exec != NULL) {
+            for (size_t j = 0; j < exec->count; j++)
+                free(exec->paths[j]);
+            free(exec->paths);
+            free(exec->argv);
+            free(exec);
+        }
+        free_dupes(expr->params[i].dupes);
+        rx_free(expr->params[i].regex);
+        free(expr->params[i].hits);
+        free(expr->params[i].value);
+    }
+    free(expr->params);
+    free_du(expr->du);
+    expr->du = NULL;
+    name_cache_free(&expr->names.users);
+    name_cache_free(&expr->names.groups);
+    expr->params = NULL;
+    expr->count = 0;
+}
+
+/**
+ * \brief Wertet die Expression für eine Datei aus.
+ *
+ * Zusätzlich werden die Dateien, deren Inhalt der Thread-Pool von -contains bereits durchsucht hat, abgeholt
+ * und zu Ende ausgewertet.
+ *
+ * \param paramc context-struct der zu prüfenden Datei
+ * \param expr die von compile_params() übersetzte Expression
+ *
+ * \func eval_params() wertet die Expression aus
+ * \func content_drain() holt die fertigen Dateien des Thread-Pools ab
+ *
+ * \return OK_NOERROR wenn erfolgreich oder einen negativen Error-Code im Fehlerfall
+ */
+static retval_t do_params(const param_context_t *paramc, const expression_t *expr) {
+    retval_t result = eval_params(paramc, expr, 0);
+
+    if (result == OK_NOERROR)
+        result = content_drain(expr->content, false);
+
+    return result;
+}
+
+/**
+ * \brief Diese Funktion geht die übersetzten Parameter ab einem Index in einer Schleife durch
+ *        und führt bei Treffer den jeweiligen 'case' aus.
+ *
+ * \param paramc context-struct der zu prüfenden Datei
+ * \param expr die von compile_params() übersetzte Expression
+ * \param start Index des ersten auszuwertenden Parameters
+ *
+ * \func handle_param() Ruft die einzelnen unterfunktionen basierend auf der OPT auf.
+ * \func do_param_contains() durchsucht die Datei im Haupt-Thread (benötigt den Lese-Buffer der Expression).
+ * \func content_submit() übergibt -contains an den Thread-Pool, falls vorhanden.
+ * \func handle_error() Errorhandling.
+ * \func emit_match() übergibt die Datei ohne Ausgabe-Option als Treffer an den Iterator (implizites -print).
+ *
+ * \return OK_NOERROR wenn erfolgreich oder einen negativen Error-Code im Fehlerfall
+ */
+static retval_t eval_params(const param_context_t *paramc, const expression_t *expr, size_t start) {
+    retval_t result = OK_PROCEED;
+    const param_t *param = NULL;
+
+    for (size_t i = start; i < expr->count; i++) {
+        // handle parameter, the content search may continue in the thread pool
+        param = &expr->params[i];
+        if (param->opt == CONTAINS && expr->content != NULL)
+            result = content_submit(expr->content, paramc, i);
+        else if (param->opt == CONTAINS)
+            result = do_param_contains(param, paramc, expr->content_buffer);
+        else if (param->opt == QUIT || param->opt == LIMIT)
+            result = do_param_quit(param, expr->iter);
+        else
+            result = handle_param(param, paramc);
+
+        // handle possible error
+        if (result != OK_PROCEED)
+            break;
+    }
+
+    // print some error-info if error happend
+    if (result < 0)
+        handle_error(param, result);
+    else {
+        // if no error or STOP happend and line is not already printed => hand it to the caller
+        if (result == OK_PROCEED && !expr->has_action)
+            result = emit_match(paramc, expr->iter);
+
+        // normalize positive return for better upstream handling
+        if (result == OK_PROCEED || result == OK_STOP || result == OK_DEFERRED)
+            result = OK_NOERROR;
+    }
+
+    debug_print("DEBUG: ended eval_params with '%d' \n", result);
+    return result;
+}
+
+/**
+ * \brief Analysiert die Benutzereingabe und liefer bei Erfolg ein ein struct mit aufbereiteten Daten.
+ *        Im Fehlerfall wird ein negativer Errorcode zurückgegeben.
+ *
+ * \param command zu überprüfender Command-String
+ * \param next_param unausgewerteter parameter der dem momentanen argument folgt (kann NULL sein)
+ * \param param Ausgabe-Pointer für das Ergebnis-Struct
+ * \func strtoopt() löst den param-string zu einem OPT auf oder gibt einen Fehlercode zurück.
+ * \func check_value() gibt als Ergebnis einen Wert des Enums RETVAL_CV zurück.
+ *
+ * \return OK_NOERROR wenn erfolgreich sonst einen negativen Errorcode
+ */
+static retval_t get_param(const char *command, const char *next_param, param_t *param) {
+    retval_t result;
+    opt_t opt;
+
+    // set INVALID in case of an error
+    param->opt = INVALID;
+
+    // check argument validity
+    if ((result = strtoopt(command, &opt)) < 0)
+        return result;
+
+    debug_print("DEBUG: found arg '%s' as OPT:'%lu'\n", command, (long)opt);
+
+    // check value validity
+    if ((result = check_value(opt, next_param)) < 0)
+        return result;
+
+    param->opt = opt;
+
+    // handle positive results
+    if (result == OK_VALUE_EXISTS) {
+        debug_print("DEBUG: using value '%s'\n", next_param);
+        param->value = strdup(next_param);
+    }
+
+    return result;
+}
+
+/**
+ * \brief Diese Funktion überprüft ob der gegebene Command-String einer gültigen Option entspricht.
+ *
+ * Er wird dazu jeder Eintrag im OPT-Enum iteriert und deie dazugehörige
+ * Zeichenkette aus OPT_NAME geholt. Diese wird dann gegen die gegebene
+ * Zeichenkette geprüft. Bei einer Übereinstimmung wird das dezugehörige
+ * Enum returniert.
+ *
+ * \param command zu überprüfender Command-String
+ * \param opt Rückgabe Pointer
+ *
+ * \return opt_t gibt als Ergebnis einen Wert des Enums OPT zurück.
+ */
+static retval_t strtoopt(const char *command, opt_t *opt) {
+    *opt = INVALID;
+    if (strlen(command) < 2 || command[0] != '-')
+        return ERR_INVALID_ARGUMENT;
+
+    for (size_t j = 0; j < OPTS_COUNT; j++) {
+        const char *current_opt = OPT_NAME[j];
+        if (strcmp(current_opt, command) == 0) {
+            *opt = (opt_t)j;
+            return OK_NOERROR;
+        }
+    };
+
+    return ERR_INVALID_ARGUMENT; // default value if no valid param is found
+}
+
+/**
+ * \brief Diese Funktion überprüft ob ein "value"-Zusatz zum Argument notwendig ist und überprüft die Gültigkeit.
+ *
+ * \param opt ausgewertetes Argument als Option-Wert
+ * \param next_parm unausgewerteter parameter der dem momentanen argument folgt (kann NULL sein)
+ *
+ * \return gibt einen positiven Statuscode zwischen zurück.Bei Erfolg einen Fehlercode < 0
+ */
+static retval_t check_value(opt_t opt, const char *next_parm) {
+    switch (opt) {
+    case PRINT:
+    case LS:
+    case NOUSER:
+    case DUPES:
+    case DU:
+    case QUIT:
+        // if no value is expected check if next param is null or a valid arg (start with '-')
+        if (next_parm != NULL && next_parm[0] != '-')
+            return ERR_VALUE_MISSING;
+        return OK_VALUE_NOTNEEDED;
+    case USER:
+    case TYPE:
+    case NAME:
+    case PATH:
+    case SIZE:
+    case MTIME:
+    case MMIN:
+    case NEWER:
+    case EXEC:
+    case CONTAINS:
+    case REGEX:
+    case IREGEX:
+    case LIMIT:
+        // if value is needed check if not null
+        if (next_parm == NULL)
+            return ERR_VALUE_UNEXPECTED;
+        return OK_VALUE_EXISTS;
+    default:
+        return ERR_NOT_IMPLEMENTED;
+    }
+}
+
+/**
+ * \brief Diese Funktion bekommt OPT übergeben und die einzelnen Unterfunktionen,
+ *        basierend auf OPT auf.
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \return reicht die return-codes der aufgerufenen do_param_*-Funktion weiter.
+ */
+static retval_t handle_param(const param_t *param, const param_context_t *paramc) {
+    debug_print("DEBUG: handle param '%s' '%s'\n", OPT_NAME[param->opt], param->value);
+
+    // call param method
+    switch (param->opt) {
+    case PRINT:
+        return do_param_print(paramc);
+    case LS:
+        return do_param_list(param, paramc);
+    case NOUSER:
+        return do_param_nouser(param, paramc);
+    case USER:
+        return do_param_user(param, paramc);
+    case TYPE:
+        return do_param_type(param, paramc);
+    case NAME:
+        return do_param_name(param, paramc);
+    case PATH:
+        return do_param_path(param, paramc);
+    case REGEX:
+    case IREGEX:
+        return do_param_regex(param, paramc);
+    case SIZE:
+        return do_param_range(param, paramc->file_stat->st_size);
+    case MTIME:
+    case MMIN:
+    case NEWER:
+        return do_param_range(param, timespec_to_ns(&paramc->file_stat->st_mtim));
+    case EXEC:
+        return do_param_exec(param, paramc);
+    case DUPES:
+        return do_param_dupes(param, paramc);
+    case DU:
+        return do_param_du(param, paramc);
+    default:
+        // should only be hit after extending the existing implementation
+        return ERR_NOT_IMPLEMENTED;
+    }
+}
+
+/**
+ * \brief Behandelt das -print Argument
+ *
+ * Es wird der Datei-Name in einer Zeile ausgegeben
+ *
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func fprintf()
+ *
+ * \return Bei Erfolg OK_PROCEED, sonst einen negativen Fehler-Code
+ */
+static retval_t do_param_print(const param_context_t *paramc) {
+    errno = 0;
+    if (fprintf(stdout, "%s\n", paramc->file_name) < 0)
+        return ERR_OUTPUT_BROKEN;
+
+    return OK_PROCEED;
+}
+
+/**
+ * \brief Behandelt die Argumente -quit und -limit
+ *
+ * Beide beenden die Traversierung: Die aktuelle Datei wird noch fertig ausgewertet, danach schließt
+ * finish_iter() alle offenen Verzeichnisse und beendet die Threads der parallelen Traversierung.
+ * Gesammelte -exec Pfade werden noch ausgeführt, wie bei find.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param iter der Iterator der Traversierung (kann NULL sein)
+ *
+ * \return STOP bei -quit, sonst PROCEED
+ */
+static retval_t do_param_quit(const param_t *param, myfind_iter_t *iter) {
+    // -limit lets the first n files pass and ends the traversal with the n-th one
+    if (param->opt == LIMIT && ++*param->hits < param->min)
+        return OK_PROCEED;
+
+    if (iter != NULL)
+        iter->quit = true;
+
+    return (param->opt == QUIT) ? OK_STOP : OK_PROCEED;
+}
+
+/**
+ * \brief Übergibt einen Treffer an den Iterator der laufenden Traversierung
+ *
+ * Wird statt des impliziten -print aufgerufen. Pfad und stat-Daten werden kopiert,
+ * da sie nur während der Auswertung gültig sind.
+ *
+ * \param paramc context-struct der zu bearbeitenden Datei
+ * \param iter Iterator der laufenden Traversierung (kann NULL sein)
+ *
+ * \return Bei Erfolg OK_PROCEED, sonst ERR_OUT_OF_MEMORY
+ */
+static retval_t emit_match(const param_context_t *paramc, myfind_iter_t *iter) {
+    if (iter == NULL)
+        return OK_PROCEED;
+
+    if (iter->match_count == iter->match_capacity) {
+        size_t capacity = (iter->match_capacity == 0) ? DIR_ENTRIES_INITIAL : iter->match_capacity * 2;
+        match_t *tmp = realloc(iter->matches, capacity * sizeof(match_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        iter->matches = tmp;
+        iter->match_capacity = capacity;
+    }
+
+    match_t *match = &iter->matches[iter->match_count];
+    if ((match->path = strdup(paramc->file_name)) == NULL)
+        return ERR_OUT_OF_MEMORY;
+    match->stat = *paramc->file_stat;
+    iter->match_count++;
+
+    return OK_PROCEED;
+}
+
+/**
+ * \brief Behandelt das -ls Argument
+ *
+ * Diese Funktion ruft die Funktionen 'snprintf_filetime()', 'snprintf_username', 'snprintf_groupname'
+ * und 'snprintf_permissions' auf, übergibt diesen die jeweiligen Parameter
+ * und gibt anschließend die Werte mittels 'fprintf()' aus.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func snprintf_filetime() bekommt eine Zahl != 0 zurück wenn erfolgreich und '0' im Fehlerfall.
+ * \func snprintf_username() bekommt strln zurück wenn erfolgreich und '0' im Fehlerfall.
+ * \func snprintf_groupname() bekommt strln zurück wenn erfolgreich und '0' im Fehlerfall.
+ * \func snprintf_permissions() übergibt über strncpy() den Array für die Permissions.
+ *
+ * \return Bei Erfolg OK_PROCEED, sonst einen negativen Fehler-Code
+ */
+static retval_t do_param_list(const param_t *param, const param_context_t *paramc) {
+    const struct stat *s = paramc->file_stat;
+
+    // Get Last Modified Time
+    char timetext[TIME_TEXT_SIZE];
+    snprintf_filetime(timetext, sizeof(timetext), &(s->st_mtim.tv_sec));
+
+    // Get User Name
+    char user_name[USERNAME_MAX];
+    if (snprintf_username(&param->names->users, user_name, sizeof(user_name), paramc->file_stat->st_uid) == 0)
+        sprintf(user_name, "%d", s->st_uid);
+
+    // Get Group Name
+    char group_name[GROUPNAME_MAX];
+    (void) snprintf_groupname(&param->names->groups, group_name, sizeof(group_name), paramc->file_stat->st_gid);
+
+    // Get Permissions
+    char permissions[PERMISSIONS_TEXT_SIZE];
+    (void) snprintf_permissions(permissions, sizeof(permissions), paramc->file_stat->st_mode);
+
+    // on error return error-code, otherwise return PROCEED
+    return (fprintf(stdout,
+                    "%6lu "           // inode
+                    "%4lu "           // blocksize
+                    "%s "             // permissions
+                    "%3d "            // linkcount
+                    "%-8s "           // username/id
+                    "%-8s "           // groupname/id
+                    "%8lu "           // size in byte
+                    "%s "             // last modified time
+                    "%s\n",           // filename/path
+                    s->st_ino,        // inode
+                    s->st_blocks / 2, // blksize - stat calculates with 512bytes blocksize ... 1024 should be used
+                    permissions,      // permissions
+                    (int)s->st_nlink, // linkcount
+                    user_name,        // username/id
+                    group_name,       // groupname/id
+                    s->st_size,       // size in byte
+                    timetext,         // last modified time
+                    paramc->file_name // filename/üath
+                    ) < 0)
+               ? ERR_OUTPUT_BROKEN
+               : OK_PROCEED;
+}
+
+/**
+ * \brief Diese Funktion gibt die Zeit der letzten Änderung des Files zurück.
+ *
+ * \param buf Char-Buffer für Ergebnis. Mindestens 80 Zeichen lang
+ * \param bufsize Buffergröße um Buffer-Overflows zu verhindern
+ * \param time Wert in UNIX_TIMESTAMP Format
+ *
+ * \func localtime_r() gibt die lokale Zeit im struct tm zurück und nutzt lt zum speichern des Ergebnisses.
+ * \func strftime() gibt die Anzahl der geschriebenen Charakter zurück, oder 0 wenn das Maximum überschritten
+ *      wird.
+ *
+ * \return Anzahl der geschriebenen Charakter, wenn erfolgreich.
+ * \return 0 im Fehlerfall.
+ */
+static size_t snprintf_filetime(char *buf, size_t bufsize, const time_t *time) {
+    struct tm lt;
+
+    localtime_r(time, &lt);
+    debug_print("DEBUG: print_filetime time: '%ld'\n", (long)time);
+    return strftime(buf, bufsize, "%b %e %H:%M", &lt);
+}
+
+/**
+ * \brief Diese Funktion sucht nach einer passenden User-ID, speichert diese in '*usr' zwischen,
+ * überprüft danach ob es sich um einen NULL-Pointer oder um einen Eintrag handelt und gibt, im Falle eines
+ * Eintrages, den Namen zurück.
+ *
+ * \param users Zwischenspeicher der Benutzernamen
+ * \param buf Char-Buffer für Ergebnis. NULL übergeben um nur zu validieren.
+ * \param bufsize Buffergröße um Buffer-Overflows zu verhindern. Wenn buf NULL hier 0 übergeben.
+ * \param uid User-ID
+ *
+ * \func name_lookup() Sucht den Namen zur User-ID (getpwuid() nur beim ersten Mal). Gibt 'NULL' im Fehlerfall zurück.
+ * \func strncpy() speichert den Namen (Zeiger auf Quell-Array) in 'buf' (Zeiger auf Ziel-Array).
+ * \func strln() gibt die Länge des String zurück.
+ *
+ * \return 0 Wenn kein User in passwd gefunden wurde oder  NULL übergeben wurde
+ * \return >0 Gibt länge des Usernamen zurück
+ */
+static size_t snprintf_username(name_cache_t *users, char *buf, size_t bufsize, uid_t uid) {
+    const char *usr = name_lookup(users, uid, false);
+    size_t len;
+
+    if (usr == NULL)
+        return 0;
+
+    len = strlen(usr);
+
+    if (buf != NULL)
+        strncpy(buf, usr, bufsize);
+
+    return len;
+}
+
+/**
+ * \brief Sucht den Gruppennamen zu einer GroupID. Gibt die länge des Namen zurück oder 0 im Fehlerfall
+ *
+ * Benützt getgrgid() um die Gruppe auszulesen.
+ * Wenn der Pointer == 'NULL', dann konnte die Group-ID nicht gefunden werden.
+ * Wenn der Pointer != 'NULL', dann wird der Gruppenname zurück gegeben.
+ * Kopiert bei Erfolg den Namen der erhalten Gruppe in buf.
+ *
+ * \param groups Zwischenspeicher der Gruppennamen
+ * \param buf Char-Buffer für Ergebnis. NULL übergeben um nur zu validieren.
+ * \param bufsize Buffergröße um Buffer-Overflows zu verhindern. Wenn buf NULL hier 0 übergeben.
+ * \param gid Gruppen-ID
+ *
+ * \func name_lookup() Sucht den Namen zur Group-ID (getgrgid() nur beim ersten Mal). Gibt 'NULL' im Fehlerfall zurück.
+ * \func strncpy() speichert den Namen (Zeiger auf Quell-Array) in 'buf' (Zeiger auf Ziel-Array).
+ * \func strln() gibt die Länge des String zurück.
+ *
+ * \return länge des Gruppennamens oder 0 im Fehlerfall
+ */
+static size_t snprintf_groupname(name_cache_t *groups, char *buf, size_t bufsize, gid_t gid) {
+    const char *grp = name_lookup(groups, gid, true);
+    size_t len;
+
+    if (grp == NULL)
+        return 0;
+
+    len = strlen(grp);
+
+    if (buf != NULL)
+        strncpy(buf, grp, bufsize);
+
+    return len;
+}
+
+/**
+ * \brief Liefert den Namen zu einer User- oder Group-ID aus dem Zwischenspeicher.
+ *
+ * Unbekannte IDs werden einmalig über NSS aufgelöst, auch IDs ohne Eintrag werden gemerkt. Die Tabelle wird
+ * verdoppelt, sobald sie zur Hälfte gefüllt ist. Kann der Name nicht gespeichert werden, wird er trotzdem geliefert.
+ *
+ * \param cache Zwischenspeicher
+ * \param id User- bzw. Group-ID
+ * \param group true für eine Group-ID, sonst User-ID
+ *
+ * \func getpwuid() bzw. getgrgid() lösen die ID auf
+ *
+ * \return der Name (gültig bis zum nächsten Aufruf) oder NULL wenn es zur ID keinen Eintrag gibt
+ */
+static const char *name_lookup(name_cache_t *cache, unsigned long id, bool group) {
+    size_t mask = cache->capacity - 1;
+    size_t hash = (size_t)((id * HASH_PRIME64_1) >> 32);
+    const char *name = NULL;
+
+    for (size_t i = hash & mask; cache->capacity > 0 && cache->slots[i].used; i = (i + 1) & mask) {
+        if (cache->slots[i].id == id)
+            return cache->slots[i].name;
+    }
+
+    if (group) {
+        struct group *grp = getgrgid((gid_t)id);
+        name = (grp != NULL) ? grp->gr_name : NULL;
+    } else {
+        struct passwd *usr = getpwuid((uid_t)id);
+        name = (usr != NULL) ? usr->pw_name : NULL;
+    }
+
+    char *copy = (name != NULL) ? strdup(name) : NULL;
+    if (name != NULL && copy == NULL)
+        return name;
+
+    if ((cache->count + 1) * 2 > cache->capacity) {
+        size_t capacity = (cache->capacity == 0) ? NAME_CACHE_INITIAL : cache->capacity * 2;
+        name_entry_t *slots = calloc(capacity, sizeof(name_entry_t));
+        if (slots == NULL) {
+            free(copy);
+            return name;
+        }
+
+        // rehash the existing entries into the bigger table
+        for (size_t i = 0; i < cache->capacity; i++) {
+            if (!cache->slots[i].used)
+                continue;
+            size_t j = (size_t)((cache->slots[i].id * HASH_PRIME64_1) >> 32) & (capacity - 1);
+            while (slots[j].used)
+                j = (j + 1) & (capacity - 1);
+            slots[j] = cache->slots[i];
+        }
+
+        free(cache->slots);
+        cache->slots = slots;
+        cache->capacity = capacity;
+        mask = capacity - 1;
+    }
+
+    size_t i = hash & mask;
+    while (cache->slots[i].used)
+        i = (i + 1) & mask;
+
+    cache->slots[i].id = id;
+    cache->slots[i].name = copy;
+    cache->slots[i].used = true;
+    cache->count++;
+    return copy;
+}
+
+/**
+ * \brief Gibt einen Namens-Zwischenspeicher frei.
+ *
+ * \param cache Zwischenspeicher
+ */
+static void name_cache_free(name_cache_t *cache) {
+    for (size_t i = 0; i < cache->capacity; i++)
+        free(cache->slots[i].name);
+    free(cache->slots);
+    cache->slots = NULL;
+    cache->count = 0;
+    cache->capacity = 0;
+}
+
+/**
+ * \brief Diese Funktion gibt die Permissions aus.
+ *
+ * \param buf Char-Buffer für Ergebnis. Mindestens 11 Zeichen lang
+ * \param bufsize Buffergröße um Buffer-Overflows zu verhindern.
+ * \param mode Das mode Bitmask-Field der zu untersuchenden Datei
+ *
+ * \func get_file_type() Wird aufgerufen um den Filetype zu ermitteln
+ * \func check_flags() Makro für Bitmask Flag-Checking
+ * \func strncpy() speichert 'lbuf' (Zeiger auf Quell-Array) in 'buf' (Zeiger auf Ziel-Array).
+ *
+ * \return Gibt die länge des Permission-Texts aus.
+ */
+static size_t snprintf_permissions(char *buf, size_t bufsize, int mode) {
+    char lbuf[PERMISSIONS_TEXT_SIZE] = "----------";
+
+    // print node-type
+    lbuf[0] = get_file_type(mode);
+
+    // regular files are displayed as '-'
+    if (lbuf[0] == 'f')
+        lbuf[0] = '-';
+
+    // print access mask
+    if (mode & S_IRUSR) {
+        lbuf[1] = 'r';
+    } // user   read
+    if (mode & S_IWUSR) {
+        lbuf[2] = 'w';
+    } // user   write
+
+    // user   execute/sticky
+    if (check_flags(mode, (S_IXUSR | S_ISUID))) {
+        lbuf[3] = 's';
+    } else if (mode & S_IXUSR) {
+        lbuf[3] = 'x';
+    } else if (mode & S_ISUID) {
+        lbuf[3] = 'S';
+    }
+
+    if (mode & S_IRGRP) {
+        lbuf[4] = 'r';
+    } // group  read
+    if (mode & S_IWGRP) {
+        lbuf[5] = 'w';
+    } // group  write
+
+    // group  execute/sticky
+    if (check_flags(mode, (S_IXGRP | S_ISGID))) {
+        lbuf[6] = 's';
+    } else if (mode & S_IXGRP) {
+        lbuf[6] = 'x';
+    } else if (mode & S_ISGID) {
+        lbuf[6] = 'S';
+    }
+
+    if (mode & S_IROTH) {
+        lbuf[7] = 'r';
+    } // other  read
+    if (mode & S_IWOTH) {
+        lbuf[8] = 'w';
+    } // other  write
+
+    // other  execute/sticky
+    if (check_flags(mode, (S_IXOTH | S_ISVTX))) {
+        lbuf[9] = 's';
+    } else if (mode & S_IXOTH) {
+        lbuf[9] = 'x';
+    } else if (mode & S_ISVTX) {
+        lbuf[9] = 'S';
+    }
+
+    strncpy(buf, lbuf, bufsize);
+    return 10; // number im characters that should be written to buffer
+}
+
+/**
+ * \brief gibt anhand des Mode-Bitmask-Fields einer Datei deren Typ als character zurück
+ *
+ * 'b' = 'S_ISBLK' => block Device
+ * 'c' = 'S_ISCHR' => char Device
+ * 'd' = 'S_ISDIR' => Verzeichnis
+ * 'p' = 'S_ISFIFO' => FiFo
+ * 'l' = 'S_ISLNK' => symbolische Verknüpfung
+ * 's' = 'S_ISOCK' => Socket
+ *
+ * \param mode Das mode Bitmask-Field der zu untersuchenden Datei
+ *
+ * \return einer der folgenden characters "bcdplsf" oder '-' wenn kein passendes Flag gefunden wurde
+ */
+static char get_file_type(int mode) {
+    if (S_ISBLK(mode)) {
+        return 'b';
+    } else if (S_ISCHR(mode)) {
+        return 'c';
+    } else if (S_ISDIR(mode)) {
+        return 'd';
+    } else if (S_ISFIFO(mode)) {
+        return 'p';
+    } else if (S_ISLNK(mode)) {
+        return 'l';
+    } else if (S_ISSOCK(mode)) {
+        return 's';
+    } else if (S_ISREG(mode)) {
+        return 'f';
+    } else {
+        return '-';
+    }
+}
+
+/**
+ * \brief Behandelt das -nouser Argument
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func snprintf_username() wird verwendet um die Benutzerid zu prüfen
+ *
+ * \return returniert PROCEED wenn kein Benutzer für die Datei gefunden wurde und sonst STOP
+ */
+static retval_t do_param_nouser(const param_t *param, const param_context_t *paramc) {
+    size_t name_len = snprintf_username(&param->names->users, NULL, 0, paramc->file_stat->st_uid);
+    return (name_len == 0) ? OK_PROCEED : OK_STOP;
+}
+
+/**
+ * \brief Behandelt das -user Argument
+ *
+ * Der Benutzer wurde bereits von compile_param_user() aufgelöst und wird gegen den Besitzer der Datei verglichen.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \return returniert PROCEED wenn der angegebene Benutzer Besitzer der Datei ist, sonst STOP.
+ */
+static retval_t do_param_user(const param_t *param, const param_context_t *paramc) {
+    debug_print("DEBUG: is uid '%lu' == '%d'?\n", (unsigned long)param->uid, paramc->file_stat->st_uid);
+    return (param->uid == paramc->file_stat->st_uid) ? OK_PROCEED : OK_STOP;
+}
+
+/**
+ * \brief Behandelt das -type Argument
+ *
+ * Der Type wurde bereits von compile_param_type() validiert,
+ * es wird nur noch der Type der Datei gegen den eingegebenen Type geprüft.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \return wenn der Type der Datei dem gesuchten Type entspricht wird PROCEED zurückgegeben, sonst STOP
+ */
+static retval_t do_param_type(const param_t *param, const param_context_t *paramc) {
+    return (get_file_type(paramc->file_stat->st_mode) == param->value[0]) ? OK_PROCEED : OK_STOP;
+}
+
+/**
+ * \brief Behandelt das -name Argument
+ *
+ * Es wird der Basisteil des voll Datei-Namen über das gegebene Pattern verglichen.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func basename() gibt die letzte Komponente des Pfardes zurück.
+ * \func fnmatch() überprüft ob 'name' mit 'value' übereinstimmt.
+ *                 Wenn Übereinstimmung, dann '0'.
+ *                 Wenn keine Übereinstimmung, dann 'FNM_NOMATCH'
+ *
+ * \return Wenn das Pattern mit dem Dateinamen übereinstimmt wird PROCEED zurückgegeben, ansonsten STOP.
+ *         Im Fehlerfall wird ein negativer Errorcode zurückgeliefert.
+ */
+static retval_t do_param_name(const param_t *param, const param_context_t *paramc) {
+    char *name = basename((char *)paramc->file_name);
+    int result = fnmatch(param->value, name, 0);
+    debug_print("DEBUG: do_param_name for '%s' with '%s' => %d\n", paramc->file_name, param->value, result);
+
+    if (result == 0)
+        return OK_PROCEED;
+    else if (result == FNM_NOMATCH)
+        return OK_STOP;
+
+    return ERR_INVALID_PATTERN;
+}
+
+/**
+ * \brief Behandelt das -path Argument
+ *
+ * Es wird der voll Datei-Namen (= Pfad) über das gegebene Pattern verglichen.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func fnmatch() überprüft ob 'file_name' mit 'value' übereinstimmt.
+ *                 Wenn Übereinstimmung, dann 0.
+ *                 Wenn keine Übereinstimmung, dann FNM_NOMATCH
+ *
+ * \return Wenn das Pattern mit dem Pfad übereinstimmt wird PROCEED zurückgegeben, ansonsten STOP.
+ *         Im Fehlerfall wird ein negativer Errorcode zurückgeliefert.
+ */
+static retval_t do_param_path(const param_t *param, const param_context_t *paramc) {
+    int result = fnmatch(param->value, paramc->file_name, 0);
+    debug_print("DEBUG: do_param_path for '%s' with '%s' => %d\n", paramc->file_name, param->value, result);
+
+    if (result == 0)
+        return OK_PROCEED;
+    else if (result == FNM_NOMATCH)
+        return OK_STOP;
+
+    return ERR_INVALID_PATTERN;
+}
+
+/**
+ * \brief Behandelt die Argumente -regex und -iregex
+ *
+ * Es wird der volle Datei-Name (= Pfad) mit dem von compile_param_regex() übersetzten Pattern verglichen.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func rx_match() vergleicht den Pfad in linearer Zeit
+ *
+ * \return Wenn das Pattern auf den Pfad passt wird PROCEED zurückgegeben, ansonsten STOP.
+ *         Im Fehlerfall wird ein negativer Errorcode zurückgeliefert.
+ */
+static retval_t do_param_regex(const param_t *param, const param_context_t *paramc) {
+    bool match = false;
+    retval_t result = rx_match(param->regex, paramc->file_name, &match);
+    debug_print("DEBUG: do_param_regex for '%s' with '%s' => %d\n", paramc->file_name, param->value, match);
+
+    if (result != OK_NOERROR)
+        return result;
+
+    return match ? OK_PROCEED : OK_STOP;
+}
+
+/**
+ * \brief Liest eine Alternative ("branch|branch|...") eines -regex Patterns.
+ *
+ * \param parser Zustand des Parsers
+ * \param node Ausgabe-Pointer für den gelesenen Knoten
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_parse_alt(rx_parser_t *parser, size_t *node) {
+    size_t branch = RX_NONE;
+    size_t alt = RX_NONE;
+
+    retval_t result = rx_parse_branch(parser, &branch);
+    *node = branch;
+    if (result != OK_NOERROR || *parser->pos != '|')
+        return result;
+
+    result = rx_new_node(parser, RX_NODE_ALT, branch, &alt);
+    while (result == OK_NOERROR && *parser->pos == '|') {
+        parser->pos++;
+        result = rx_parse_branch(parser, &branch);
+        if (result == OK_NOERROR)
+            result = rx_add_child(parser, alt, branch);
+    }
+
+    *node = alt;
+    return result;
+}
+
+/**
+ * \brief Liest eine Verkettung von Wiederholungen bis zum nächsten '|', ')' oder zum Ende des Patterns.
+ *
+ * \param parser Zustand des Parsers
+ * \param node Ausgabe-Pointer für den gelesenen Knoten, eine leere Verkettung passt auf den leeren Text
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_parse_branch(rx_parser_t *parser, size_t *node) {
+    size_t piece = RX_NONE;
+
+    retval_t result = rx_new_node(parser, RX_NODE_CAT, RX_NONE, node);
+    while (result == OK_NOERROR && *parser->pos != '\0' && *parser->pos != '|' && *parser->pos != ')') {
+        result = rx_parse_piece(parser, &piece);
+        if (result == OK_NOERROR)
+            result = rx_add_child(parser, *node, piece);
+    }
+
+    return result;
+}
+
+/**
+ * \brief Liest ein Atom gefolgt von beliebig vielen Wiederholungen ('*', '+', '?', {n}, {n,}, {n,m}).
+ *
+ * \param parser Zustand des Parsers
+ * \param node Ausgabe-Pointer für den gelesenen Knoten
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_parse_piece(rx_parser_t *parser, size_t *node) {
+    size_t repeat = RX_NONE;
+    int min = 0;
+    int max = 0;
+
+    retval_t result = rx_parse_atom(parser, node);
+    while (result == OK_NOERROR) {
+        char c = *parser->pos;
+
+        if (c == '*' || c == '+' || c == '?') {
+            min = (c == '+') ? 1 : 0;
+            max = (c == '?') ? 1 : -1;
+            parser->pos++;
+        } else if (c == '{' && isdigit((unsigned char)parser->pos[1]))
+            result = rx_parse_interval(parser, &min, &max);
+        else
+            break;
+
+        if (result == OK_NOERROR)
+            result = rx_new_node(parser, RX_NODE_REPEAT, *node, &repeat);
+        if (result == OK_NOERROR) {
+            parser->nodes[repeat].min = min;
+            parser->nodes[repeat].max = max;
+            *node = repeat;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * \brief Liest ein Atom: eine Gruppe, einen Klammerausdruck, '.', einen Anker oder ein (maskiertes) Zeichen.
+ *
+ * Ein '{' das keine Wiederholung beginnt ist ein normales Zeichen. Rückverweise (\1 bis \9) werden abgelehnt,
+ * da sie keine reguläre Sprache beschreiben und nicht mit einem DFA geprüft werden können.
+ *
+ * \param parser Zustand des Parsers, zeigt auf ein Zeichen das kein '|' oder ')' ist
+ * \param node Ausgabe-Pointer für den gelesenen Knoten
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_parse_atom(rx_parser_t *parser, size_t *node) {
+    rx_bytes_t bytes = {{0}};
+    unsigned char c = (unsigned char)*parser->pos;
+    retval_t result;
+
+    switch (c) {
+    case '(':
+        if (++parser->depth > RX_DEPTH_MAX)
+            return ERR_INVALID_PATTERN;
+        parser->pos++;
+        result = rx_parse_alt(parser, node);
+        if (result == OK_NOERROR && *parser->pos != ')')
+            result = ERR_INVALID_PATTERN;
+        parser->pos++;
+        parser->depth--;
+        return result;
+    case '^':
+        parser->pos++;
+        return rx_new_node(parser, RX_NODE_BOL, RX_NONE, node);
+    case '$':
+        parser->pos++;
+        return rx_new_node(parser, RX_NODE_EOL, RX_NONE, node);
+    case '*':
+    case '+':
+    case '?':
+        // nothing to repeat
+        return ERR_INVALID_PATTERN;
+    case '.':
+        memset(&bytes, 0xff, sizeof(bytes));
+        parser->pos++;
+        break;
+    case '[':
+        parser->pos++;
+        if ((result = rx_parse_bracket(parser, &bytes)) != OK_NOERROR)
+            return result;
+        break;
+    case '\\':
+        c = (unsigned char)parser->pos[1];
+        if (c == '\0' || (c >= '1' && c <= '9'))
+            return ERR_INVALID_PATTERN;
+        rx_set(&bytes, c);
+        parser->pos += 2;
+        break;
+    default:
+        rx_set(&bytes, c);
+        parser->pos++;
+        break;
+    }
+
+    return rx_new_bytes(parser, &bytes, node);
+}
+
+/**
+ * \brief Liest einen Klammerausdruck ("[abc]", "[^a-z]", "[[:digit:]_]").
+ *
+ * Ein ']' direkt nach '[' oder '[^' ist ein normales Zeichen, '\' hat keine besondere Bedeutung.
+ *
+ * \param parser Zustand des Parsers, zeigt auf das Zeichen nach '['
+ * \param bytes Ausgabe-Pointer für die Byte-Menge
+ *
+ * \func strstr() sucht das Ende einer Zeichenklasse
+ *
+ * \return OK_NOERROR oder ERR_INVALID_PATTERN
+ */
+static retval_t rx_parse_bracket(rx_parser_t *parser, rx_bytes_t *bytes) {
+    static const struct {
+        const char *name;
+        int (*is)(int);
+    } CLASSES[] = {{"alnum", isalnum}, {"alpha", isalpha}, {"blank", isblank}, {"cntrl", iscntrl},
+                   {"digit", isdigit}, {"graph", isgraph}, {"lower", islower}, {"print", isprint},
+                   {"punct", ispunct}, {"space", isspace}, {"upper", isupper}, {"xdigit", isxdigit}};
+    const char *p = parser->pos;
+    bool negate = (*p == '^');
+
+    if (negate)
+        p++;
+
+    for (bool first = true; first || *p != ']'; first = false) {
+        if (*p == '\0')
+            return ERR_INVALID_PATTERN;
+
+        if (p[0] == '[' && p[1] == ':') {
+            const char *end = strstr(p + 2, ":]");
+            size_t len = (end != NULL) ? (size_t)(end - p - 2) : 0;
+            size_t i = 0;
+
+            while (end != NULL && i < sizeof(CLASSES) / sizeof(CLASSES[0]) &&
+                   (strlen(CLASSES[i].name) != len || strncmp(CLASSES[i].name, p + 2, len) != 0))
+                i++;
+            if (end == NULL || i == sizeof(CLASSES) / sizeof(CLASSES[0]))
+                return ERR_INVALID_PATTERN;
+
+            for (int c = 1; c < 256; c++) {
+                if (CLASSES[i].is(c))
+                    rx_set(bytes, c);
+            }
+            p = end + 2;
+            continue;
+        }
+
+        unsigned char lo = (unsigned char)*p++;
+        unsigned char hi = lo;
+        if (p[0] == '-' && p[1] != ']' && p[1] != '\0') {
+            hi = (unsigned char)p[1];
+            p += 2;
+            if (hi < lo)
+                return ERR_INVALID_PATTERN;
+        }
+        for (int c = lo; c <= hi; c++)
+            rx_set(bytes, c);
+    }
+    parser->pos = p + 1;
+
+    // fold before negating, so [^a] excludes 'A' as well with -iregex
+    if (parser->icase)
+        rx_fold(bytes);
+    if (negate) {
+        for (size_t i = 0; i < 4; i++)
+            bytes->bits[i] = ~bytes->bits[i];
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Liest die Grenzen einer Wiederholung {n}, {n,} oder {n,m}.
+ *
+ * \param parser Zustand des Parsers, zeigt auf '{' gefolgt von einer Ziffer
+ * \param min Ausgabe-Pointer für die minimale Anzahl
+ * \param max Ausgabe-Pointer für die maximale Anzahl, -1 für unbegrenzt
+ *
+ * \func strtoul() liest die Grenzen
+ *
+ * \return OK_NOERROR oder ERR_INVALID_PATTERN
+ */
+static retval_t rx_parse_interval(rx_parser_t *parser, int *min, int *max) {
+    char *end;
+    unsigned long lo = strtoul(parser->pos + 1, &end, 10);
+    unsigned long hi = lo;
+    bool bounded = true;
+
+    if (*end == ',') {
+        if (isdigit((unsigned char)end[1]))
+            hi = strtoul(end + 1, &end, 10);
+        else {
+            bounded = false;
+            end++;
+        }
+    }
+
+    if (*end != '}' || lo > RX_REPEAT_MAX || (bounded && (hi > RX_REPEAT_MAX || hi < lo)))
+        return ERR_INVALID_PATTERN;
+
+    *min = (int)lo;
+    *max = bounded ? (int)hi : -1;
+    parser->pos = end + 1;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Erstellt einen Knoten im Syntaxbaum.
+ *
+ * \param parser Zustand des Parsers
+ * \param kind Art des Knotens
+ * \param child erstes Kind oder RX_NONE
+ * \param node Ausgabe-Pointer für den Index des Knotens
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN wenn der Baum zu tief wird oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_new_node(rx_parser_t *parser, rx_kind_t kind, size_t child, size_t *node) {
+    int depth = (child == RX_NONE) ? 1 : parser->nodes[child].depth + 1;
+    if (depth > RX_DEPTH_MAX)
+        return ERR_INVALID_PATTERN;
+
+    if (parser->count == parser->capacity) {
+        size_t capacity = (parser->capacity == 0) ? FRAMES_INITIAL : parser->capacity * 2;
+        rx_node_t *tmp = realloc(parser->nodes, capacity * sizeof(rx_node_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        parser->nodes = tmp;
+        parser->capacity = capacity;
+    }
+
+    parser->nodes[parser->count] = (rx_node_t){kind, child, RX_NONE, 0, 0, 0, depth};
+    *node = parser->count++;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Fügt einem RX_NODE_CAT oder RX_NODE_ALT Knoten ein Kind hinzu (vor den bisherigen Kindern).
+ *
+ * \param parser Zustand des Parsers
+ * \param node Eltern-Knoten
+ * \param child neues Kind
+ *
+ * \return OK_NOERROR oder ERR_INVALID_PATTERN wenn der Baum zu tief wird
+ */
+static retval_t rx_add_child(rx_parser_t *parser, size_t node, size_t child) {
+    rx_node_t *nodes = parser->nodes;
+
+    if (nodes[child].depth + 1 > RX_DEPTH_MAX)
+        return ERR_INVALID_PATTERN;
+
+    nodes[child].sibling = nodes[node].child;
+    nodes[node].child = child;
+    if (nodes[node].depth < nodes[child].depth + 1)
+        nodes[node].depth = nodes[child].depth + 1;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Erstellt einen RX_NODE_BYTES Knoten und speichert dessen Byte-Menge im Pattern.
+ *
+ * \param parser Zustand des Parsers
+ * \param bytes Byte-Menge, bei -iregex werden beide Schreibweisen ergänzt
+ * \param node Ausgabe-Pointer für den Index des Knotens
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_new_bytes(rx_parser_t *parser, const rx_bytes_t *bytes, size_t *node) {
+    rx_t *rx = parser->rx;
+
+    if (rx->set_count == rx->set_capacity) {
+        size_t capacity = (rx->set_capacity == 0) ? FRAMES_INITIAL : rx->set_capacity * 2;
+        rx_bytes_t *tmp = realloc(rx->sets, capacity * sizeof(rx_bytes_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        rx->sets = tmp;
+        rx->set_capacity = capacity;
+    }
+
+    rx_bytes_t *set = &rx->sets[rx->set_count];
+    *set = *bytes;
+    if (parser->icase)
+        rx_fold(set);
+    // paths never contain '\0', so it is never matched (e.g. by '.' or [^a])
+    set->bits[0] &= ~1ULL;
+
+    retval_t result = rx_new_node(parser, RX_NODE_BYTES, RX_NONE, node);
+    if (result == OK_NOERROR)
+        parser->nodes[*node].bytes = rx->set_count++;
+    return result;
+}
+
+/**
+ * \brief Ergänzt eine Byte-Menge um die jeweils andere Schreibweise der enthaltenen Buchstaben.
+ *
+ * \param bytes Byte-Menge
+ *
+ * \func tolower() und toupper() bestimmen die Schreibweisen (C-Locale)
+ */
+static void rx_fold(rx_bytes_t *bytes) {
+    rx_bytes_t folded = *bytes;
+
+    for (int c = 0; c < 256; c++) {
+        if (rx_has(bytes, c)) {
+            rx_set(&folded, tolower(c));
+            rx_set(&folded, toupper(c));
+        }
+    }
+
+    *bytes = folded;
+}
+
+/**
+ * \brief Erstellt den NFA für einen Knoten des Syntaxbaums vor einem bereits erstellten Folgezustand.
+ *
+ * Die Rekursion ist durch die Tiefe des Baums begrenzt (RX_DEPTH_MAX), nicht durch die Länge des Patterns.
+ *
+ * \param rx das entstehende Pattern
+ * \param nodes Syntaxbaum
+ * \param node zu übersetzender Knoten
+ * \param next Zustand der nach dem Knoten folgt
+ * \param start Ausgabe-Pointer für den ersten Zustand des Knotens
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN wenn der NFA zu groß wird oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_emit(rx_t *rx, const rx_node_t *nodes, size_t node, uint32_t next, uint32_t *start) {
+    const rx_node_t *n = &nodes[node];
+    retval_t result = OK_NOERROR;
+    uint32_t cur = next;
+    uint32_t body = 0;
+    uint32_t loop = 0;
+
+    switch (n->kind) {
+    case RX_NODE_BYTES:
+        if ((result = rx_new_state(rx, RX_CHAR, next, 0, &cur)) == OK_NOERROR)
+            rx->nfa[cur].set = (uint32_t)n->bytes;
+        break;
+    case RX_NODE_BOL:
+    case RX_NODE_EOL:
+        result = rx_new_state(rx, (n->kind == RX_NODE_BOL) ? RX_BOL : RX_EOL, next, 0, &cur);
+        break;
+    case RX_NODE_CAT:
+        // the children are linked last to first, so every child is built in front of its successor
+        for (size_t child = n->child; child != RX_NONE && result == OK_NOERROR; child = nodes[child].sibling)
+            result = rx_emit(rx, nodes, child, cur, &cur);
+        break;
+    case RX_NODE_ALT:
+        for (size_t child = n->child; child != RX_NONE && result == OK_NOERROR; child = nodes[child].sibling) {
+            result = rx_emit(rx, nodes, child, next, &body);
+            if (result == OK_NOERROR && child == n->child)
+                cur = body;
+            else if (result == OK_NOERROR)
+                result = rx_new_state(rx, RX_SPLIT, body, cur, &cur);
+        }
+        break;
+    case RX_NODE_REPEAT:
+        // x* is a split in front of x, x leads back to the split
+        if (n->max < 0) {
+            result = rx_new_state(rx, RX_SPLIT, 0, next, &loop);
+            if (result == OK_NOERROR)
+                result = rx_emit(rx, nodes, n->child, loop, &body);
+            if (result == OK_NOERROR) {
+                rx->nfa[loop].out = body;
+                cur = loop;
+            }
+        }
+        // x{n,m} is x repeated n times followed by m - n optional x, each of them may skip the rest
+        for (int i = n->min; i < n->max && result == OK_NOERROR; i++) {
+            result = rx_emit(rx, nodes, n->child, cur, &body);
+            if (result == OK_NOERROR)
+                result = rx_new_state(rx, RX_SPLIT, body, next, &cur);
+        }
+        for (int i = 0; i < n->min && result == OK_NOERROR; i++)
+            result = rx_emit(rx, nodes, n->child, cur, &cur);
+        break;
+    }
+
+    *start = cur;
+    return result;
+}
+
+/**
+ * \brief Erstellt einen NFA-Zustand.
+ *
+ * \param rx das entstehende Pattern
+ * \param op Art des Zustands
+ * \param out Folgezustand
+ * \param alt zweiter Folgezustand bei RX_SPLIT
+ * \param state Ausgabe-Pointer für den Index des Zustands
+ *
+ * \return OK_NOERROR, ERR_INVALID_PATTERN wenn der NFA mehr als RX_NFA_MAX Zustände hätte oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_new_state(rx_t *rx, rx_op_t op, uint32_t out, uint32_t alt, uint32_t *state) {
+    if (rx->nfa_count == RX_NFA_MAX)
+        return ERR_INVALID_PATTERN;
+
+    if (rx->nfa_count == rx->nfa_capacity) {
+        size_t capacity = (rx->nfa_capacity == 0) ? FRAMES_INITIAL : rx->nfa_capacity * 2;
+        rx_state_t *tmp = realloc(rx->nfa, capacity * sizeof(rx_state_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        rx->nfa = tmp;
+        rx->nfa_capacity = capacity;
+    }
+
+    rx->nfa[rx->nfa_count] = (rx_state_t){op, out, alt, 0};
+    *state = (uint32_t)rx->nfa_count++;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Prüft ob ein Pattern auf den ganzen Text passt.
+ *
+ * Jedes Byte ist ein Übergang im DFA. Nur noch nicht berechnete Übergänge werden mit rx_step() aus dem NFA
+ * bestimmt, sobald kein NFA-Zustand mehr übrig ist wird abgebrochen.
+ *
+ * \param rx das übersetzte Pattern
+ * \param text zu prüfender Text (Pfad)
+ * \param match Ausgabe-Pointer für das Ergebnis
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_match(rx_t *rx, const char *text, bool *match) {
+    retval_t result;
+    size_t count = 0;
+
+    *match = false;
+
+    if (rx->start == RX_UNKNOWN) {
+        rx_next_generation(rx);
+        rx_closure(rx, rx->root, true, false, rx->work, &count);
+        qsort(rx->work, count, sizeof(uint32_t), compare_rx_state);
+        if ((result = rx_add_state(rx, count, true, &rx->start)) != OK_NOERROR)
+            return result;
+    }
+
+    int32_t state = rx->start;
+    for (const unsigned char *p = (const unsigned char *)text; *p != '\0'; p++) {
+        int32_t next = rx->dfa[state].next[*p];
+
+        if (next == RX_UNKNOWN && (result = rx_step(rx, state, *p, &next)) != OK_NOERROR)
+            return result;
+        if (next == RX_DEAD)
+            return OK_NOERROR;
+        state = next;
+    }
+
+    *match = rx->dfa[state].accept;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Berechnet den Übergang eines DFA-Zustands für ein Byte.
+ *
+ * \param rx das übersetzte Pattern
+ * \param from DFA-Zustand
+ * \param c gelesenes Byte
+ * \param next Ausgabe-Pointer für den Folgezustand oder RX_DEAD
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_step(rx_t *rx, int32_t from, unsigned char c, int32_t *next) {
+    size_t flushes = rx->flushes;
+    size_t count = 0;
+    retval_t result;
+
+    rx_next_generation(rx);
+    for (size_t i = 0; i < rx->dfa[from].count; i++) {
+        const rx_state_t *state = &rx->nfa[rx->dfa[from].nfa[i]];
+        if (state->op == RX_CHAR && rx_has(&rx->sets[state->set], c))
+            rx_closure(rx, state->out, false, false, rx->work, &count);
+    }
+
+    *next = RX_DEAD;
+    if (count > 0) {
+        qsort(rx->work, count, sizeof(uint32_t), compare_rx_state);
+        if ((result = rx_add_state(rx, count, false, next)) != OK_NOERROR)
+            return result;
+    }
+
+    // after a flush the state the transition starts from is gone
+    if (rx->flushes == flushes)
+        rx->dfa[from].next[c] = *next;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Sucht den DFA-Zustand zur sortierten NFA-Menge in rx->work oder erstellt ihn.
+ *
+ * Ist der Cache voll, wird er vorher mit rx_flush() geleert.
+ *
+ * \param rx das übersetzte Pattern
+ * \param count Anzahl der NFA-Zustände in rx->work
+ * \param start true für den Start-Zustand
+ * \param state Ausgabe-Pointer für den Index des DFA-Zustands
+ *
+ * \func hash_update() hasht die NFA-Menge für die Hash-Tabelle
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t rx_add_state(rx_t *rx, size_t count, bool start, int32_t *state) {
+    const size_t mask = 2 * RX_DFA_MAX - 1;
+    hash_state_t hash_state;
+    size_t slot;
+
+    hash_init(&hash_state);
+    hash_update(&hash_state, rx->work, count * sizeof(uint32_t));
+    uint64_t hash = hash_digest(&hash_state);
+
+    for (slot = hash & mask; rx->table[slot] >= 0; slot = (slot + 1) & mask) {
+        const rx_dfa_state_t *dfa = &rx->dfa[rx->table[slot]];
+        if (dfa->hash == hash && dfa->count == count && dfa->start == start &&
+            memcmp(dfa->nfa, rx->work, count * sizeof(uint32_t)) == 0) {
+            *state = rx->table[slot];
+            return OK_NOERROR;
+        }
+    }
+
+    if (rx->dfa_count == RX_DFA_MAX) {
+        rx_flush(rx);
+        slot = hash & mask;
+    }
+
+    if (rx->dfa_count == rx->dfa_capacity) {
+        size_t capacity = (rx->dfa_capacity == 0) ? FRAMES_INITIAL : rx->dfa_capacity * 2;
+        rx_dfa_state_t *tmp = realloc(rx->dfa, capacity * sizeof(rx_dfa_state_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        rx->dfa = tmp;
+        rx->dfa_capacity = capacity;
+    }
+
+    rx_dfa_state_t *dfa = &rx->dfa[rx->dfa_count];
+    if ((dfa->nfa = malloc((count > 0 ? count : 1) * sizeof(uint32_t))) == NULL)
+        return ERR_OUT_OF_MEMORY;
+    memcpy(dfa->nfa, rx->work, count * sizeof(uint32_t));
+    memset(dfa->next, 0xff, sizeof(dfa->next)); // RX_UNKNOWN
+    dfa->count = count;
+    dfa->hash = hash;
+    dfa->start = start;
+    dfa->accept = false;
+
+    // the path may end here if the final state is reachable, possibly through '$'
+    size_t reached = 0;
+    rx_next_generation(rx);
+    for (size_t i = 0; i < count; i++) {
+        if (rx->nfa[dfa->nfa[i]].op == RX_MATCH)
+            dfa->accept = true;
+        else if (rx->nfa[dfa->nfa[i]].op == RX_EOL)
+            rx_closure(rx, rx->nfa[dfa->nfa[i]].out, start, true, rx->scratch, &reached);
+    }
+    for (size_t i = 0; i < reached; i++) {
+        if (rx->nfa[rx->scratch[i]].op == RX_MATCH)
+            dfa->accept = true;
+    }
+
+    rx->table[slot] = (int32_t)rx->dfa_count;
+    *state = (int32_t)rx->dfa_count++;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Fügt einer NFA-Menge alle Zustände hinzu die von einem Zustand ohne zu lesen erreichbar sind.
+ *
+ * Bereits in dieser Generation besuchte Zustände werden übersprungen, daher enthält die Menge jeden Zustand
+ * höchstens einmal und Schleifen ohne Zeichen (z.B. "(a*)*") terminieren.
+ *
+ * \param rx das übersetzte Pattern
+ * \param state Ausgangs-Zustand
+ * \param at_start true am Anfang des Pfades ('^' passt)
+ * \param at_end true am Ende des Pfades ('$' passt), sonst bleibt RX_EOL in der Menge
+ * \param set NFA-Menge mit Platz für alle NFA-Zustände
+ * \param count Anzahl der Zustände in set, wird erhöht
+ */
+static void rx_closure(rx_t *rx, uint32_t state, bool at_start, bool at_end, uint32_t *set, size_t *count) {
+    size_t top = 0;
+
+    rx->stack[top++] = state;
+    while (top > 0) {
+        state = rx->stack[--top];
+        if (rx->mark[state] == rx->generation)
+            continue;
+        rx->mark[state] = rx->generation;
+
+        const rx_state_t *nfa = &rx->nfa[state];
+        switch (nfa->op) {
+        case RX_SPLIT:
+            rx->stack[top++] = nfa->alt;
+            rx->stack[top++] = nfa->out;
+            break;
+        case RX_BOL:
+            if (at_start)
+                rx->stack[top++] = nfa->out;
+            break;
+        case RX_EOL:
+            if (at_end)
+                rx->stack[top++] = nfa->out;
+            else
+                set[(*count)++] = state;
+            break;
+        default:
+            set[(*count)++] = state;
+            break;
+        }
+    }
+}
+
+/**
+ * \brief Beginnt eine neue Generation für rx_closure(), alle Zustände gelten danach als nicht besucht.
+ *
+ * \param rx das übersetzte Pattern
+ */
+static void rx_next_generation(rx_t *rx) {
+    // after an overflow old marks would look current again
+    if (++rx->generation == 0) {
+        memset(rx->mark, 0, rx->nfa_count * sizeof(uint32_t));
+        rx->generation = 1;
+    }
+}
+
+/**
+ * \brief Verwirft alle DFA-Zustände, sie werden bei Bedarf neu berechnet.
+ *
+ * \param rx das übersetzte Pattern
+ */
+static void rx_flush(rx_t *rx) {
+    for (size_t i = 0; i < rx->dfa_count; i++)
+        free(rx->dfa[i].nfa);
+
+    rx->dfa_count = 0;
+    memset(rx->table, 0xff, 2 * RX_DFA_MAX * sizeof(int32_t));
+    rx->start = RX_UNKNOWN;
+    rx->flushes++;
+}
+
+/**
+ * \brief Vergleichsfunktion für qsort() der NFA-Mengen
+ */
+static int compare_rx_state(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief Gibt ein übersetztes Pattern frei.
+ *
+ * \param rx freizugebendes Pattern (kann NULL sein)
+ */
+static void rx_free(rx_t *rx) {
+    if (rx == NULL)
+        return;
+
+    for (size_t i = 0; i < rx->dfa_count; i++)
+        free(rx->dfa[i].nfa);
+    free(rx->dfa);
+    free(rx->table);
+    free(rx->nfa);
+    free(rx->sets);
+    free(rx->mark);
+    free(rx->stack);
+    free(rx->work);
+    free(rx->scratch);
+    free(rx);
+}
+
+/**
+ * \brief Behandelt die Argumente -size, -mtime, -mmin und -newer
+ *
+ * Die Grenzen wurden bereits von compile_param() vorberechnet, daher ist pro Datei nur ein
+ * Bereichs-Vergleich auf den bereits gelesenen stat-Daten nötig.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param key der zu vergleichende Wert aus den stat-Daten (Größe oder Zeit in Nanosekunden)
+ *
+ * \return PROCEED wenn key innerhalb der Grenzen liegt, sonst STOP
+ */
+static retval_t do_param_range(const param_t *param, int64_t key) {
+    return (key >= param->min && key <= param->max) ? OK_PROCEED : OK_STOP;
+}
+
+/**
+ * \brief Behandelt das -exec Argument
+ *
+ * Bei ';' wird das Kommando für die Datei gestartet, dabei wird jedes '{}' durch den Pfad ersetzt.
+ * Das Ergebnis ist PROCEED wenn das Kommando mit 0 beendet wurde. Steht -exec am Ende der Expression,
+ * wird nicht auf das Kommando gewartet (siehe compile_params()).
+ * Bei '{} +' wird der Pfad gesammelt und das Kommando erst gestartet, wenn das nächste Argument ARG_MAX
+ * überschreiten würde. Das Ergebnis ist dann immer PROCEED.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func exec_flush() startet die gesammelten Pfade
+ * \func exec_replace() ersetzt '{}' in einem Argument
+ * \func exec_spawn() startet das Kommando
+ *
+ * \return PROCEED, STOP oder ERR_OUT_OF_MEMORY
+ */
+static retval_t do_param_exec(const param_t *param, const param_context_t *paramc) {
+    exec_t *exec = param->exec;
+
+    if (exec->batch) {
+        size_t size = sizeof(char *) + strlen(paramc->file_name) + 1;
+
+        // start the collected paths first if this one would not fit anymore
+        if (exec->count > 0 && exec->size + size > exec->size_max) {
+            retval_t result = exec_flush(exec);
+            if (result < 0)
+                return result;
+        }
+
+        if (exec->count == exec->capacity) {
+            size_t capacity = (exec->capacity == 0) ? DIR_ENTRIES_INITIAL : exec->capacity * 2;
+            char **tmp = realloc(exec->paths, capacity * sizeof(char *));
+            if (tmp == NULL)
+                return ERR_OUT_OF_MEMORY;
+            exec->paths = tmp;
+            exec->capacity = capacity;
+        }
+
+        if ((exec->paths[exec->count] = strdup(paramc->file_name)) == NULL)
+            return ERR_OUT_OF_MEMORY;
+        exec->count++;
+        exec->size += size;
+        return OK_PROCEED;
+    }
+
+    char *argv[exec->argc + 1];
+    retval_t result = OK_PROCEED;
+
+    memset(argv, 0, sizeof(argv));
+    for (size_t i = 0; i < exec->argc && result == OK_PROCEED; i++) {
+        if (strstr(exec->argv[i], EXEC_PLACEHOLDER) == NULL)
+            argv[i] = (char *)exec->argv[i];
+        else if ((argv[i] = exec_replace(exec->argv[i], paramc->file_name)) == NULL)
+            result = ERR_OUT_OF_MEMORY;
+    }
+
+    if (result == OK_PROCEED)
+        result = exec_spawn(exec->pool, argv, exec->async, false);
+
+    // free the arguments with replaced placeholders
+    for (size_t i = 0; i < exec->argc; i++) {
+        if (argv[i] != exec->argv[i])
+            free(argv[i]);
+    }
+
+    return result;
+}
+
+/**
+ * \brief Startet das Kommando eines -exec ... {} + mit allen gesammelten Pfaden asynchron.
+ *
+ * \param exec das übersetzte -exec Argument
+ *
+ * \func exec_spawn() startet das Kommando
+ *
+ * \return Ergebnis von exec_spawn() oder ERR_OUT_OF_MEMORY
+ */
+static retval_t exec_flush(exec_t *exec) {
+    retval_t result;
+
+    if (exec->count == 0)
+        return OK_PROCEED;
+
+    char **argv = calloc(exec->argc + exec->count + 1, sizeof(char *));
+    if (argv == NULL)
+        return ERR_OUT_OF_MEMORY;
+
+    memcpy(argv, exec->argv, exec->argc * sizeof(char *));
+    memcpy(argv + exec->argc, exec->paths, exec->count * sizeof(char *));
+
+    debug_print("DEBUG: exec batch '%s' with %lu paths\n", argv[0], (unsigned long)exec->count);
+    result = exec_spawn(exec->pool, argv, true, true);
+
+    // posix_spawn returns after the child called exec, so the strings can be freed now
+    for (size_t i = 0; i < exec->count; i++) {
+        exec->size -= sizeof(char *) + strlen(exec->paths[i]) + 1;
+        free(exec->paths[i]);
+    }
+    free(argv);
+
+    exec->count = 0;
+    return result;
+}
+
+/**
+ * \brief Startet ein Kommando mit posix_spawnp().
+ *
+ * Vor dem Start wird stdout geleert, damit die Ausgaben in der richtigen Reihenfolge erscheinen.
+ * Asynchrone Prozesse werden im Pool gezählt, laufen bereits max_jobs Prozesse wird vorher auf einen gewartet.
+ * Wie bei find beeinflussen nur -exec ... + Kommandos den Exit-Status, ihre Prozess-IDs werden dafür gemerkt.
+ *
+ * \param pool Prozess-Pool
+ * \param argv NULL-terminierte Argumente, argv[0] ist das Kommando
+ * \param async true wenn nicht auf das Ende des Prozesses gewartet werden soll
+ * \param batch true bei einem -exec ... + Kommando (immer async)
+ *
+ * \func posix_spawnp() startet das Kommando ohne die Kosten eines fork()
+ * \func waitpid() wartet auf das Ende des Prozesses
+ *
+ * \return PROCEED wenn das Kommando asynchron gestartet oder mit 0 beendet wurde, sonst STOP
+ *         oder ERR_OUT_OF_MEMORY
+ */
+static retval_t exec_spawn(exec_pool_t *pool, char *const argv[], bool async, bool batch) {
+    pid_t pid;
+    int status;
+    int err;
+
+    if (async)
+        exec_wait(pool, pool->max_jobs - 1);
+
+    if (batch && pool->batch_count == pool->batch_capacity) {
+        size_t capacity = (pool->batch_capacity == 0) ? EXEC_BATCHES_INITIAL : pool->batch_capacity * 2;
+        pid_t *tmp = realloc(pool->batches, capacity * sizeof(pid_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        pool->batches = tmp;
+        pool->batch_capacity = capacity;
+    }
+
+    (void)fflush(stdout);
+    if ((err = posix_spawnp(&pid, argv[0], NULL, NULL, argv, environ)) != 0) {
+        error(ERR_NONCRITICAL, err, "can't execute '%s'", argv[0]);
+        if (batch)
+            pool->failed = true;
+        return OK_STOP;
+    }
+
+    if (async) {
+        pool->running++;
+        if (batch)
+            pool->batches[pool->batch_count++] = pid;
+        return OK_PROCEED;
+    }
+
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            error(ERR_NONCRITICAL, errno, "can't wait for '%s'", argv[0]);
+            errno = 0;
+            return OK_STOP;
+        }
+    }
+
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? OK_PROCEED : OK_STOP;
+}
+
+/**
+ * \brief Wartet auf asynchrone Prozesse, bis höchstens max_running Prozesse laufen.
+ *
+ * Ein fehlgeschlagenes -exec ... + Kommando setzt failed, das Ergebnis eines asynchronen ';' wird ignoriert.
+ *
+ * \param pool Prozess-Pool
+ * \param max_running maximale Anzahl an Prozessen die nach dem Aufruf noch laufen dürfen
+ *
+ * \func waitpid() wartet auf das Ende eines beliebigen Kind-Prozesses
+ */
+static void exec_wait(exec_pool_t *pool, unsigned long max_running) {
+    int status;
+    pid_t pid;
+
+    while (pool->running > max_running) {
+        if ((pid = waitpid(-1, &status, 0)) == -1) {
+            if (errno == EINTR)
+                continue;
+            // no more children, the counter is out of sync
+            errno = 0;
+            pool->running = 0;
+            pool->batch_count = 0;
+            break;
+        }
+
+        pool->running--;
+        for (size_t i = 0; i < pool->batch_count; i++) {
+            if (pool->batches[i] == pid) {
+                pool->batches[i] = pool->batches[--pool->batch_count];
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                    pool->failed = true;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * \brief Ersetzt jedes Vorkommen von '{}' in einem Argument durch den Pfad.
+ *
+ * \param arg Argument der Kommando-Vorlage
+ * \param file_name einzusetzender Pfad
+ *
+ * \return neu allokierter String oder NULL wenn nicht genug Speicher vorhanden ist
+ */
+static char *exec_replace(const char *arg, const char *file_name) {
+    size_t name_len = strlen(file_name);
+    size_t placeholder_len = strlen(EXEC_PLACEHOLDER);
+    size_t count = 0;
+
+    for (const char *p = arg; (p = strstr(p, EXEC_PLACEHOLDER)) != NULL; p += placeholder_len)
+        count++;
+
+    char *result = malloc(strlen(arg) + count * name_len + 1);
+    if (result == NULL)
+        return NULL;
+
+    char *out = result;
+    const char *p;
+    while ((p = strstr(arg, EXEC_PLACEHOLDER)) != NULL) {
+        memcpy(out, arg, (size_t)(p - arg));
+        out += p - arg;
+        memcpy(out, file_name, name_len);
+        out += name_len;
+        arg = p + placeholder_len;
+    }
+    strcpy(out, arg);
+
+    return result;
+}
+
+/**
+ * \brief Behandelt das -contains Argument im Haupt-Thread
+ *
+ * Es werden nur reguläre Dateien bis zur maximalen Größe (--max-content-size) durchsucht.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments (min = Länge des Suchtexts, max = Größenlimit)
+ * \param paramc context-struct der zu bearbeitenden Datei
+ * \param buf Lese-Buffer mit mindestens CONTENT_CHUNK_SIZE + Länge des Suchtexts Bytes
+ *
+ * \func search_file() durchsucht den Inhalt der Datei
+ *
+ * \return PROCEED wenn die Datei den Suchtext enthält, sonst STOP
+ */
+static retval_t do_param_contains(const param_t *param, const param_context_t *paramc, char *buf) {
+    const struct stat *s = paramc->file_stat;
+
+    if (!S_ISREG(s->st_mode) || s->st_size > param->max)
+        return OK_STOP;
+
+    // the empty string is contained in every file
+    if (param->min == 0)
+        return OK_PROCEED;
+
+    return search_file(paramc->file_name, param->value, (size_t)param->min, buf) ? OK_PROCEED : OK_STOP;
+}
+
+/**
+ * \brief Durchsucht den Inhalt einer Datei nach einer Zeichenkette.
+ *
+ * Die Datei wird in Blöcken von CONTENT_CHUNK_SIZE gelesen. Die letzten needle_len - 1 Bytes eines Blocks
+ * werden an den Anfang des Buffers kopiert, damit auch Treffer über eine Blockgrenze gefunden werden.
+ * Statt mmap() wird read() verwendet, da eine gemappte Datei die währenddessen gekürzt wird (z.B. Logrotation)
+ * zu einem SIGBUS führen würde.
+ *
+ * \param file_name Pfad der Datei
+ * \param needle gesuchte Zeichenkette
+ * \param needle_len Länge der gesuchten Zeichenkette (> 0)
+ * \param buf Lese-Buffer mit mindestens CONTENT_CHUNK_SIZE + needle_len Bytes
+ *
+ * \func posix_fadvise() kündigt dem Kernel sequentielles Lesen an (größeres Read-Ahead)
+ * \func search_substring() sucht im gelesenen Block
+ *
+ * \return true wenn die Zeichenkette gefunden wurde
+ */
+static bool search_file(const char *file_name, const char *needle, size_t needle_len, char *buf) {
+    size_t keep = 0;
+    bool found = false;
+
+    if (buf == NULL) {
+        error(ERR_NONCRITICAL, ENOMEM, "can't search '%s'", file_name);
+        return false;
+    }
+
+    int fd = open(file_name, O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (fd == -1) {
+        error(ERR_NONCRITICAL, errno, "can't open '%s'", file_name);
+        errno = 0;
+        return false;
+    }
+
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    for (;;) {
+        ssize_t len = read(fd, buf + keep, CONTENT_CHUNK_SIZE);
+        if (len == -1 && errno == EINTR)
+            continue;
+        if (len == -1) {
+            error(ERR_NONCRITICAL, errno, "can't read '%s'", file_name);
+            errno = 0;
+            break;
+        }
+        if (len == 0)
+            break;
+
+        size_t total = keep + (size_t)len;
+        if (search_substring(buf, total, needle, needle_len) != NULL) {
+            found = true;
+            break;
+        }
+
+        // keep the tail, a match may span two chunks
+        keep = (total < needle_len - 1) ? total : needle_len - 1;
+        memmove(buf, buf + total - keep, keep);
+    }
+
+    (void)close(fd);
+    return found;
+}
+
+/**
+ * \brief Sucht eine Zeichenkette in einem Speicherbereich.
+ *
+ * Mit SSE2 werden jeweils 16 mögliche Startpositionen gleichzeitig geprüft: Nur wo das erste und das letzte
+ * Zeichen der gesuchten Zeichenkette übereinstimmen, wird der Rest mit memcmp() verglichen. Der Rest des
+ * Bereichs (bzw. alles ohne SSE2) wird mit memmem() durchsucht.
+ *
+ * \param haystack zu durchsuchender Speicherbereich
+ * \param haystack_len Länge des Speicherbereichs
+ * \param needle gesuchte Zeichenkette
+ * \param needle_len Länge der gesuchten Zeichenkette
+ *
+ * \return Pointer auf den ersten Treffer oder NULL
+ */
+static const char *search_substring(const char *haystack, size_t haystack_len, const char *needle,
+                                    size_t needle_len) {
+    if (needle_len == 0)
+        return haystack;
+    if (haystack_len < needle_len)
+        return NULL;
+    if (needle_len == 1)
+        return memchr(haystack, needle[0], haystack_len);
+
+#ifdef __SSE2__
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    size_t i = 0;
+
+    for (; i + needle_len - 1 + sizeof(__m128i) <= haystack_len; i += sizeof(__m128i)) {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(haystack + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(haystack + i + needle_len - 1));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+
+        while (mask != 0) {
+            unsigned int bit = (unsigned int)__builtin_ctz(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, needle_len - 2) == 0)
+                return haystack + i + bit;
+            mask &= mask - 1;
+        }
+    }
+
+    haystack += i;
+    haystack_len -= i;
+#endif
+
+    return memmem(haystack, haystack_len, needle, needle_len);
+}
+
+/**
+ * \brief Bereitet die Suche für -contains vor.
+ *
+ * Mit mehr als einem Job (-j) werden die Threads des Thread-Pools gestartet, sonst wird nur der
+ * Lese-Buffer für den Haupt-Thread allokiert. Ohne -contains passiert nichts.
+ *
+ * \param expr die übersetzte Expression
+ * \param threads Anzahl der zu startenden Threads
+ *
+ * \func pthread_create() startet die Threads mit content_worker()
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t content_start(expression_t *expr, unsigned long threads) {
+    size_t needle_max = 0;
+    bool needed = false;
+
+    for (size_t i = 0; i < expr->count; i++) {
+        if (expr->params[i].opt == CONTAINS) {
+            needed = true;
+            if ((size_t)expr->params[i].min > needle_max)
+                needle_max = (size_t)expr->params[i].min;
+        }
+    }
+
+    if (!needed)
+        return OK_NOERROR;
+
+    size_t buffer_size = CONTENT_CHUNK_SIZE + needle_max;
+    if (threads <= 1) {
+        expr->content_buffer = malloc(buffer_size);
+        return (expr->content_buffer != NULL) ? OK_NOERROR : ERR_OUT_OF_MEMORY;
+    }
+
+    content_pool_t *pool = calloc(1, sizeof(content_pool_t));
+    if (pool == NULL || (pool->threads = calloc(threads, sizeof(pthread_t))) == NULL) {
+        free(pool);
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    pool->expr = expr;
+    pool->buffer_size = buffer_size;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->job_ready, NULL);
+    pthread_cond_init(&pool->job_done, NULL);
+
+    for (unsigned long i = 0; i < threads; i++) {
+        int err = pthread_create(&pool->threads[pool->thread_count], NULL, content_worker, pool);
+        if (err != 0) {
+            // work with the threads we got
+            error(ERR_NONCRITICAL, err, "can't start thread for -contains");
+            break;
+        }
+        pool->thread_count++;
+    }
+
+    // no thread at all, search in the main thread
+    if (pool->thread_count == 0) {
+        content_stop(pool);
+        expr->content_buffer = malloc(buffer_size);
+        return (expr->content_buffer != NULL) ? OK_NOERROR : ERR_OUT_OF_MEMORY;
+    }
+
+    debug_print("DEBUG: started %lu threads for -contains\n", (unsigned long)pool->thread_count);
+    expr->content = pool;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Übergibt eine Datei für -contains an den Thread-Pool.
+ *
+ * Dateien die nicht durchsucht werden müssen, werden sofort beantwortet. Ist die Warteschlange voll,
+ * wird gewartet bis ein Thread einen Auftrag fertig bearbeitet hat.
+ *
+ * \param pool Thread-Pool
+ * \param paramc context-struct der zu bearbeitenden Datei
+ * \param index Index des -contains Parameters in der Expression
+ *
+ * \return OK_DEFERRED wenn die Datei durchsucht wird, PROCEED oder STOP wenn das Ergebnis bereits feststeht,
+ *         ERR_OUT_OF_MEMORY im Fehlerfall
+ */
+static retval_t content_submit(content_pool_t *pool, const param_context_t *paramc, size_t index) {
+    const param_t *param = &pool->expr->params[index];
+    const struct stat *s = paramc->file_stat;
+
+    if (!S_ISREG(s->st_mode) || s->st_size > param->max)
+        return OK_STOP;
+
+    // the empty string is contained in every file
+    if (param->min == 0)
+        return OK_PROCEED;
+
+    content_job_t *job = malloc(sizeof(content_job_t));
+    if (job == NULL || (job->file_name = strdup(paramc->file_name)) == NULL) {
+        free(job);
+        return ERR_OUT_OF_MEMORY;
+    }
+    job->next = NULL;
+    job->file_stat = *s;
+    job->index = index;
+    job->dir = paramc->dir;
+    job->match = false;
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending_count >= pool->thread_count * CONTENT_QUEUE_PER_THREAD)
+        pthread_cond_wait(&pool->job_done, &pool->lock);
+
+    if (pool->pending_tail != NULL)
+        pool->pending_tail->next = job;
+    else
+        pool->pending = job;
+    pool->pending_tail = job;
+    pool->pending_count++;
+    pool->in_flight++;
+
+    pthread_cond_signal(&pool->job_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    return OK_DEFERRED;
+}
+
+/**
+ * \brief Holt die fertig durchsuchten Dateien ab und wertet für Treffer den Rest der Expression aus.
+ *
+ * \param pool Thread-Pool (kann NULL sein)
+ * \param wait_all true um zu warten bis alle Aufträge fertig sind, sonst werden nur die fertigen abgeholt
+ *
+ * \func eval_params() setzt die Auswertung nach dem -contains Parameter fort
+ *
+ * \return OK_NOERROR oder den ersten Fehler der Auswertung
+ */
+static retval_t content_drain(content_pool_t *pool, bool wait_all) {
+    retval_t result = OK_NOERROR;
+
+    if (pool == NULL)
+        return OK_NOERROR;
+
+    const myfind_iter_t *iter = pool->expr->iter;
+    for (;;) {
+        // after -quit or -limit the files not yet searched are dropped and finished ones not evaluated
+        pthread_mutex_lock(&pool->lock);
+        while (iter != NULL && iter->quit && pool->pending != NULL) {
+            content_job_t *job = pool->pending;
+            pool->pending = job->next;
+            pool->pending_count--;
+            pool->in_flight--;
+            free(job->file_name);
+            free(job);
+        }
+        if (pool->pending == NULL)
+            pool->pending_tail = NULL;
+        while (wait_all && pool->in_flight > 0 && pool->done == NULL)
+            pthread_cond_wait(&pool->job_done, &pool->lock);
+
+        content_job_t *jobs = pool->done;
+        pool->done = NULL;
+        pool->done_tail = NULL;
+        for (content_job_t *job = jobs; job != NULL; job = job->next)
+            pool->in_flight--;
+        pthread_mutex_unlock(&pool->lock);
+
+        // nothing finished (yet)
+        if (jobs == NULL)
+            break;
+
+        // evaluation may submit new jobs, so the lock must not be held here
+        while (jobs != NULL) {
+            content_job_t *next = jobs->next;
+            param_context_t paramc = {jobs->file_name, &jobs->file_stat, jobs->dir};
+
+            if (jobs->match && result == OK_NOERROR && (iter == NULL || !iter->quit))
+                result = eval_params(&paramc, pool->expr, jobs->index + 1);
+
+            free(jobs->file_name);
+            free(jobs);
+            jobs = next;
+        }
+
+        if (!wait_all)
+            break;
+    }
+
+    return result;
+}
+
+/**
+ * \brief Thread-Funktion des Thread-Pools von -contains
+ *
+ * Nimmt Aufträge aus der Warteschlange, durchsucht die Datei und legt den Auftrag in die Liste
+ * der fertigen Aufträge, bis der Pool beendet wird.
+ *
+ * \param arg der Thread-Pool
+ *
+ * \return NULL
+ */
+static void *content_worker(void *arg) {
+    content_pool_t *pool = arg;
+    char *buf = malloc(pool->buffer_size);
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->pending == NULL && !pool->shutdown)
+            pthread_cond_wait(&pool->job_ready, &pool->lock);
+
+        content_job_t *job = pool->pending;
+        if (job == NULL)
+            break; // shutdown and nothing left to do
+
+        pool->pending = job->next;
+        if (pool->pending == NULL)
+            pool->pending_tail = NULL;
+        pool->pending_count--;
+        pthread_mutex_unlock(&pool->lock);
+
+        const param_t *param = &pool->expr->params[job->index];
+        job->match = search_file(job->file_name, param->value, (size_t)param->min, buf);
+
+        pthread_mutex_lock(&pool->lock);
+        job->next = NULL;
+        if (pool->done_tail != NULL)
+            pool->done_tail->next = job;
+        else
+            pool->done = job;
+        pool->done_tail = job;
+        pthread_cond_broadcast(&pool->job_done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    free(buf);
+    return NULL;
+}
+
+/**
+ * \brief Beendet die Threads des Thread-Pools und gibt ihn frei.
+ *
+ * \param pool Thread-Pool (kann NULL sein)
+ */
+static void content_stop(content_pool_t *pool) {
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->job_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->thread_count; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    // only left if the traversal was aborted
+    while (pool->done != NULL) {
+        content_job_t *next = pool->done->next;
+        free(pool->done->file_name);
+        free(pool->done);
+        pool->done = next;
+    }
+
+    pthread_cond_destroy(&pool->job_done);
+    pthread_cond_destroy(&pool->job_ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
+
+/**
+ * \brief Behandelt das -dupes Argument
+ *
+ * Es werden nur reguläre Dateien mit Inhalt gesammelt, die Duplikate werden erst nach der Traversierung von
+ * dupes_report() gesucht. Von Dateien mit mehreren Hardlinks wird nur der erste gefundene Pfad gesammelt,
+ * da alle Pfade auf denselben Inhalt zeigen und kein Speicherplatz gespart werden kann. Wird symbolischen
+ * Links gefolgt, kann jede Datei mehrfach erreicht werden, dann werden alle Dateien so geprüft.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func devino_insert() merkt sich (st_dev, st_ino) von Dateien mit mehreren Hardlinks
+ *
+ * \return PROCEED oder ERR_OUT_OF_MEMORY
+ */
+static retval_t do_param_dupes(const param_t *param, const param_context_t *paramc) {
+    dupes_t *dupes = param->dupes;
+    const struct stat *s = paramc->file_stat;
+    retval_t result;
+
+    if (!S_ISREG(s->st_mode) || s->st_size == 0)
+        return OK_PROCEED;
+
+    if ((s->st_nlink > 1 || dupes->all_links) &&
+        (result = devino_insert(&dupes->links, s->st_dev, s->st_ino)) != OK_NOERROR)
+        return (result == OK_VALUE_EXISTS) ? OK_PROCEED : result;
+
+    if (dupes->count == dupes->capacity) {
+        size_t capacity = (dupes->capacity == 0) ? DIR_ENTRIES_INITIAL : dupes->capacity * 2;
+        dupe_file_t *tmp = realloc(dupes->files, capacity * sizeof(dupe_file_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        dupes->files = tmp;
+        dupes->capacity = capacity;
+    }
+
+    dupe_file_t *file = &dupes->files[dupes->count];
+    if ((file->file_name = strdup(paramc->file_name)) == NULL)
+        return ERR_OUT_OF_MEMORY;
+    file->size = s->st_size;
+    file->partial = 0;
+    file->full = 0;
+    file->failed = false;
+    dupes->count++;
+
+    return OK_PROCEED;
+}
+
+/**
+ * \brief Sucht die Duplikate unter den gesammelten Dateien und gibt sie gruppiert aus.
+ *
+ * Die Suche erfolgt in Stufen, damit nur so wenig wie möglich gelesen werden muss:
+ *   1. Dateien werden nach der Größe aus den stat-Daten gruppiert, Dateien mit eindeutiger Größe fallen weg.
+ *   2. Für die restlichen Dateien wird ein Hash über die ersten und letzten DUPES_EDGE_SIZE Bytes berechnet.
+ *      Kleine Dateien werden dabei bereits ganz gelesen.
+ *   3. Nur für Dateien deren Größe und Teil-Hash noch übereinstimmen, wird der ganze Inhalt gehasht.
+ * Nach jeder Stufe wird das Array neu sortiert, damit gleiche Dateien nebeneinander liegen.
+ * Die Gruppen werden nach Größe absteigend ausgegeben und durch eine Leerzeile getrennt.
+ *
+ * \param dupes Zustand des -dupes Arguments
+ * \param threads Anzahl der Threads für die Hash-Berechnung
+ *
+ * \func qsort() sortiert die Dateien mit compare_dupe()
+ * \func dupes_hash() berechnet die Hashes einer Stufe
+ *
+ * \return OK_NOERROR, ERR_OUT_OF_MEMORY oder ERR_OUTPUT_BROKEN
+ */
+static retval_t dupes_report(dupes_t *dupes, unsigned long threads) {
+    dupe_file_t *files = dupes->files;
+    size_t count = dupes->count;
+    bool first_group = true;
+
+    if (count < 2)
+        return OK_NOERROR;
+
+    size_t *index = malloc(count * sizeof(size_t));
+    if (index == NULL)
+        return ERR_OUT_OF_MEMORY;
+
+    qsort(files, count, sizeof(dupe_file_t), compare_dupe);
+
+    for (int stage = 0; stage < 2; stage++) {
+        bool full = (stage == 1);
+        size_t selected = 0;
+
+        // only files that still have a partner are read, small files are already complete after the first stage
+        for (size_t i = 0; i < count; i++) {
+            if (full && files[i].size <= 2 * DUPES_EDGE_SIZE)
+                continue;
+            if ((i > 0 && dupes_equal(&files[i - 1], &files[i])) ||
+                (i + 1 < count && dupes_equal(&files[i], &files[i + 1])))
+                index[selected++] = i;
+        }
+
+        debug_print("DEBUG: -dupes stage %d hashes %lu of %lu files\n", stage, (unsigned long)selected,
+                    (unsigned long)count);
+
+        dupes_hash(files, index, selected, full, threads);
+        qsort(files, count, sizeof(dupe_file_t), compare_dupe);
+    }
+    free(index);
+
+    for (size_t i = 0; i < count; i++) {
+        bool prev = (i > 0 && dupes_equal(&files[i - 1], &files[i]));
+        bool next = (i + 1 < count && dupes_equal(&files[i], &files[i + 1]));
+
+        if (!prev && !next)
+            continue;
+
+        errno = 0;
+        if ((!prev && !first_group && fprintf(stdout, "\n") < 0) || fprintf(stdout, "%s\n", files[i].file_name) < 0)
+            return ERR_OUTPUT_BROKEN;
+        first_group = false;
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Berechnet die Hashes einer Stufe von dupes_report(), bei Bedarf mit mehreren Threads.
+ *
+ * Die Threads holen sich den jeweils nächsten Index aus einer gemeinsamen Liste, dadurch verteilen sich
+ * große und kleine Dateien von selbst gleichmäßig. Jeder Thread schreibt nur in die Einträge seiner Indizes.
+ *
+ * \param files Dateien des -dupes Arguments
+ * \param index Indizes der zu berechnenden Dateien
+ * \param count Anzahl der Indizes
+ * \param full true für den Hash über den ganzen Inhalt, sonst über Anfang und Ende
+ * \param threads maximale Anzahl an Threads
+ *
+ * \func pthread_create() startet die Threads mit dupes_worker()
+ */
+static void dupes_hash(dupe_file_t *files, const size_t *index, size_t count, bool full, unsigned long threads) {
+    dupes_work_t work = {files, index, count, 0, full, PTHREAD_MUTEX_INITIALIZER};
+    size_t started = 0;
+
+    if (threads > count)
+        threads = count;
+
+    pthread_t tids[threads > 1 ? threads : 1];
+    for (unsigned long i = 0; threads > 1 && i < threads; i++) {
+        int err = pthread_create(&tids[started], NULL, dupes_worker, &work);
+        if (err != 0) {
+            // work with the threads we got
+            error(ERR_NONCRITICAL, err, "can't start thread for -dupes");
+            break;
+        }
+        started++;
+    }
+
+    // without threads the main thread does all the work, otherwise it only helps
+    if (started == 0)
+        (void)dupes_worker(&work);
+
+    for (size_t i = 0; i < started; i++)
+        pthread_join(tids[i], NULL);
+
+    pthread_mutex_destroy(&work.lock);
+}
+
+/**
+ * \brief Thread-Funktion für dupes_hash()
+ *
+ * \param arg die gemeinsame Arbeitsliste (dupes_work_t)
+ *
+ * \return NULL
+ */
+static void *dupes_worker(void *arg) {
+    dupes_work_t *work = arg;
+    char *buf = malloc(CONTENT_CHUNK_SIZE);
+
+    for (;;) {
+        pthread_mutex_lock(&work->lock);
+        size_t next = work->next++;
+        pthread_mutex_unlock(&work->lock);
+
+        if (next >= work->count)
+            break;
+
+        dupes_hash_file(&work->files[work->index[next]], work->full, buf);
+    }
+
+    free(buf);
+    return NULL;
+}
+
+/**
+ * \brief Berechnet den Teil-Hash bzw. den vollständigen Hash einer Datei.
+ *
+ * Der Teil-Hash wird über die ersten und die letzten DUPES_EDGE_SIZE Bytes berechnet. Ist die Datei nicht
+ * größer als diese beiden Bereiche, wird sie ganz gelesen und der Teil-Hash ist gleichzeitig der vollständige.
+ * Kann die Datei nicht gelesen werden, wird sie als fehlerhaft markiert und bei der Ausgabe ignoriert.
+ *
+ * \param file zu berechnende Datei
+ * \param full true für den Hash über den ganzen Inhalt
+ * \param buf Lese-Buffer mit mindestens CONTENT_CHUNK_SIZE Bytes (NULL wenn die Allokierung fehlgeschlagen ist)
+ *
+ * \func pread() liest Anfang und Ende der Datei
+ * \func read() liest die Datei blockweise für den vollständigen Hash
+ */
+static void dupes_hash_file(dupe_file_t *file, bool full, char *buf) {
+    hash_state_t state;
+    ssize_t len;
+
+    if (buf == NULL) {
+        error(ERR_NONCRITICAL, ENOMEM, "can't hash '%s'", file->file_name);
+        file->failed = true;
+        return;
+    }
+
+    int fd = open(file->file_name, O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (fd == -1) {
+        error(ERR_NONCRITICAL, errno, "can't open '%s'", file->file_name);
+        errno = 0;
+        file->failed = true;
+        return;
+    }
+
+    hash_init(&state);
+    if (!full && file->size > 2 * DUPES_EDGE_SIZE) {
+        // head and tail, the file may have changed since the traversal so short reads are fine
+        len = pread(fd, buf, DUPES_EDGE_SIZE, 0);
+        if (len > 0) {
+            hash_update(&state, buf, (size_t)len);
+            len = pread(fd, buf, DUPES_EDGE_SIZE, file->size - DUPES_EDGE_SIZE);
+        }
+        if (len > 0)
+            hash_update(&state, buf, (size_t)len);
+    } else {
+        if (full)
+            (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        while ((len = read(fd, buf, CONTENT_CHUNK_SIZE)) != 0) {
+            if (len == -1 && errno == EINTR)
+                continue;
+            if (len == -1)
+                break;
+            hash_update(&state, buf, (size_t)len);
+        }
+    }
+
+    if (len == -1) {
+        error(ERR_NONCRITICAL, errno, "can't read '%s'", file->file_name);
+        errno = 0;
+        file->failed = true;
+    } else if (full) {
+        file->full = hash_digest(&state);
+    } else {
+        file->partial = hash_digest(&state);
+        if (file->size <= 2 * DUPES_EDGE_SIZE)
+            file->full = file->partial;
+    }
+
+    (void)close(fd);
+}
+
+/**
+ * \brief Prüft ob zwei Dateien nach dem bisherigen Stand der Hash-Berechnung gleich sind
+ *
+ * \return true wenn beide lesbar sind und Größe und alle bisher berechneten Hashes übereinstimmen
+ */
+static bool dupes_equal(const dupe_file_t *a, const dupe_file_t *b) {
+    return !a->failed && !b->failed && a->size == b->size && a->partial == b->partial && a->full == b->full;
+}
+
+/**
+ * \brief Vergleichsfunktion für qsort() von dupe_file_t
+ *
+ * Sortiert nach Größe absteigend, danach nach Fehler-Status, den Hashes und dem Pfad, damit gleiche
+ * Dateien nebeneinander und in einer stabilen Reihenfolge liegen.
+ */
+static int compare_dupe(const void *a, const void *b) {
+    const dupe_file_t *fa = a;
+    const dupe_file_t *fb = b;
+
+    if (fa->size != fb->size)
+        return (fa->size < fb->size) - (fa->size > fb->size);
+    if (fa->failed != fb->failed)
+        return fa->failed - fb->failed;
+    if (fa->partial != fb->partial)
+        return (fa->partial > fb->partial) - (fa->partial < fb->partial);
+    if (fa->full != fb->full)
+        return (fa->full > fb->full) - (fa->full < fb->full);
+    return strcmp(fa->file_name, fb->file_name);
+}
+
+/**
+ * \brief Verwirft die gesammelten Dateien eines -dupes Arguments.
+ *
+ * \param dupes Zustand des -dupes Arguments
+ */
+static void clear_dupes(dupes_t *dupes) {
+    for (size_t i = 0; i < dupes->count; i++)
+        free(dupes->files[i].file_name);
+    free(dupes->files);
+    dupes->files = NULL;
+    dupes->count = 0;
+    dupes->capacity = 0;
+    devino_free(&dupes->links);
+}
+
+/**
+ * \brief Gibt den Zustand eines -dupes Arguments frei.
+ *
+ * \param dupes freizugebender Zustand (kann NULL sein)
+ */
+static void free_dupes(dupes_t *dupes) {
+    if (dupes == NULL)
+        return;
+
+    clear_dupes(dupes);
+    free(dupes);
+}
+
+/**
+ * \brief Behandelt das -du Argument
+ *
+ * Der belegte Platz (st_blocks) wird nur dem Verzeichnis zugerechnet in dem die Datei liegt bzw. bei einem
+ * Verzeichnis diesem selbst. Die Summen über die Unterverzeichnisse bildet erst du_report(), dadurch können
+ * auch Dateien, die der Thread-Pool von -contains erst später liefert, noch gezählt werden.
+ * Dateien mit mehreren Hardlinks werden wie bei du nur beim ersten gefundenen Pfad gezählt.
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param paramc context-struct der zu bearbeitenden Datei
+ *
+ * \func devino_insert() merkt sich (st_dev, st_ino) von Dateien mit mehreren Hardlinks
+ *
+ * \return PROCEED oder ERR_OUT_OF_MEMORY
+ */
+static retval_t do_param_du(const param_t *param, const param_context_t *paramc) {
+    du_t *du = param->du;
+    const struct stat *s = paramc->file_stat;
+    retval_t result;
+
+    // a directory always has several links, but is only reached twice when following symbolic links
+    if (((s->st_nlink > 1 && !S_ISDIR(s->st_mode)) || du->all_links) &&
+        (result = devino_insert(&du->links, s->st_dev, s->st_ino)) != OK_NOERROR)
+        return (result == OK_VALUE_EXISTS) ? OK_PROCEED : result;
+
+    du_dir_t *dir = &du->dirs[paramc->dir];
+    dir->blocks += s->st_blocks;
+    if (!S_ISDIR(s->st_mode))
+        dir->files++;
+
+    return OK_PROCEED;
+}
+
+/**
+ * \brief Ordnet einen Eintrag der Traversierung einem Verzeichnis der -du Tabelle zu.
+ *
+ * Jedes Verzeichnis und jedes Start-Verzeichnis (auch wenn es keines ist) bekommt einen eigenen Eintrag in der
+ * Tabelle, alle anderen Einträge werden dem Verzeichnis zugerechnet, in dem sie liegen.
+ *
+ * \param du Verzeichnis-Tabelle
+ * \param paramc context-struct des Eintrags, erhält den Index des Verzeichnisses
+ * \param depth Tiefe des Eintrags unter dem Start-Verzeichnis
+ * \param parent Index des Verzeichnisses in dem der Eintrag liegt oder DU_NONE beim Start-Verzeichnis
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t du_enter(du_t *du, param_context_t *paramc, size_t depth, size_t parent) {
+    if (depth == 0 || S_ISDIR(paramc->file_stat->st_mode))
+        return du_add_dir(du, paramc->file_name, parent, depth, &paramc->dir);
+
+    paramc->dir = parent;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Trägt ein Verzeichnis in die Tabelle von -du ein.
+ *
+ * \param du Verzeichnis-Tabelle
+ * \param path Pfad des Verzeichnisses
+ * \param parent Index des übergeordneten Verzeichnisses oder DU_NONE
+ * \param depth Tiefe unter dem Start-Verzeichnis
+ * \param index Ausgabe-Pointer für den Index des neuen Eintrags
+ *
+ * \return OK_NOERROR oder ERR_OUT_OF_MEMORY
+ */
+static retval_t du_add_dir(du_t *du, const char *path, size_t parent, size_t depth, size_t *index) {
+    if (du->count == du->capacity) {
+        size_t capacity = (du->capacity == 0) ? DIR_ENTRIES_INITIAL : du->capacity * 2;
+        du_dir_t *tmp = realloc(du->dirs, capacity * sizeof(du_dir_t));
+        if (tmp == NULL)
+            return ERR_OUT_OF_MEMORY;
+        du->dirs = tmp;
+        du->capacity = capacity;
+    }
+
+    du_dir_t *dir = &du->dirs[du->count];
+    if ((dir->path = strdup(path)) == NULL)
+        return ERR_OUT_OF_MEMORY;
+    dir->parent = parent;
+    dir->depth = depth;
+    dir->blocks = 0;
+    dir->files = 0;
+
+    *index = du->count++;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Summiert die Verzeichnisse von -du und gibt sie nach Größe absteigend aus.
+ *
+ * Da jedes Verzeichnis nach seinem übergeordneten Verzeichnis eingetragen wurde, reicht ein Durchlauf von hinten
+ * nach vorne um die Summen vom Stack nach oben weiterzugeben. Pro Verzeichnis wird eine Zeile mit der Größe
+ * in KiB (aufgerundet, wie du -k), der Anzahl der Dateien und dem Pfad ausgegeben.
+ *
+ * \param du Verzeichnis-Tabelle
+ * \param max_depth nur Verzeichnisse bis zu dieser Tiefe ausgeben, negativ für alle
+ *
+ * \func qsort() sortiert die Verzeichnisse mit compare_du_dir()
+ *
+ * \return OK_NOERROR oder ERR_OUTPUT_BROKEN
+ */
+static retval_t du_report(du_t *du, long max_depth) {
+    for (size_t i = du->count; i-- > 0;) {
+        const du_dir_t *dir = &du->dirs[i];
+        if (dir->parent != DU_NONE) {
+            du->dirs[dir->parent].blocks += dir->blocks;
+            du->dirs[dir->parent].files += dir->files;
+        }
+    }
+
+    // the parent indices are not needed anymore
+    qsort(du->dirs, du->count, sizeof(du_dir_t), compare_du_dir);
+
+    for (size_t i = 0; i < du->count; i++) {
+        const du_dir_t *dir = &du->dirs[i];
+        if (max_depth >= 0 && dir->depth > (size_t)max_depth)
+            continue;
+
+        errno = 0;
+        if (fprintf(stdout, "%lld\t%llu\t%s\n", (long long)(dir->blocks + 1) / 2, (unsigned long long)dir->files,
+                    dir->path) < 0)
+            return ERR_OUTPUT_BROKEN;
+    }
+
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Vergleichsfunktion für qsort(), sortiert nach Größe absteigend und danach nach Pfad
+ */
+static int compare_du_dir(const void *a, const void *b) {
+    const du_dir_t *da = a;
+    const du_dir_t *db = b;
+
+    if (da->blocks != db->blocks)
+        return (da->blocks < db->blocks) - (da->blocks > db->blocks);
+    return strcmp(da->path, db->path);
+}
+
+/**
+ * \brief Verwirft die Verzeichnisse der -du Tabelle.
+ *
+ * \param du Verzeichnis-Tabelle
+ */
+static void clear_du(du_t *du) {
+    for (size_t i = 0; i < du->count; i++)
+        free(du->dirs[i].path);
+    free(du->dirs);
+    du->dirs = NULL;
+    du->count = 0;
+    du->capacity = 0;
+    devino_free(&du->links);
+}
+
+/**
+ * \brief Gibt die Verzeichnis-Tabelle von -du frei.
+ *
+ * \param du freizugebende Tabelle (kann NULL sein)
+ */
+static void free_du(du_t *du) {
+    if (du == NULL)
+        return;
+
+    clear_du(du);
+    free(du);
+}
+
+/**
+ * \brief Fügt ein (st_dev, st_ino) Paar in das Set ein.
+ *
+ * Die Tabelle wird verdoppelt, sobald sie zur Hälfte gefüllt ist.
+ *
+ * \param set Hash-Set
+ * \param dev Gerät der Datei
+ * \param ino Inode-Nummer der Datei
+ *
+ * \return OK_NOERROR wenn eingefügt, OK_VALUE_EXISTS wenn bereits vorhanden oder ERR_OUT_OF_MEMORY
+ */
+static retval_t devino_insert(devino_set_t *set, dev_t dev, ino_t ino) {
+    if ((set->count + 1) * 2 > set->capacity) {
+        size_t capacity = (set->capacity == 0) ? DEVINO_SET_INITIAL : set->capacity * 2;
+        devino_t *slots = calloc(capacity, sizeof(devino_t));
+        if (slots == NULL)
+            return ERR_OUT_OF_MEMORY;
+
+        // rehash the existing entries into the bigger table
+        for (size_t i = 0; i < set->capacity; i++) {
+            if (!set->slots[i].used)
+                continue;
+            size_t j = devino_hash(set->slots[i].dev, set->slots[i].ino) & (capacity - 1);
+            while (slots[j].used)
+                j = (j + 1) & (capacity - 1);
+            slots[j] = set->slots[i];
+        }
+
+        free(set->slots);
+        set->slots = slots;
+        set->capacity = capacity;
+    }
+
+    size_t i = devino_hash(dev, ino) & (set->capacity - 1);
+    while (set->slots[i].used) {
+        if (set->slots[i].dev == dev && set->slots[i].ino == ino)
+            return OK_VALUE_EXISTS;
+        i = (i + 1) & (set->capacity - 1);
+    }
+
+    set->slots[i].dev = dev;
+    set->slots[i].ino = ino;
+    set->slots[i].used = true;
+    set->count++;
+    return OK_NOERROR;
+}
+
+/**
+ * \brief Prüft ob ein (st_dev, st_ino) Paar im Set enthalten ist.
+ *
+ * \param set Hash-Set
+ * \param dev Gerät der Datei
+ * \param ino Inode-Nummer der Datei
+ *
+ * \return true wenn das Paar enthalten ist
+ */
+static bool devino_contains(const devino_set_t *set, dev_t dev, ino_t ino) {
+    if (set->count == 0)
+        return false;
+
+    size_t mask = set->capacity - 1;
+    for (size_t i = devino_hash(dev, ino) & mask; set->slots[i].used; i = (i + 1) & mask) {
+        if (set->slots[i].dev == dev && set->slots[i].ino == ino)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * \brief Entfernt ein (st_dev, st_ino) Paar aus dem Set.
+ *
+ * Damit lineares Sondieren ohne Grabsteine funktioniert, werden die folgenden Einträge derselben Kette
+ * in die frei gewordene Lücke zurückgeschoben (backward shift deletion).
+ *
+ * \param set Hash-Set
+ * \param dev Gerät der Datei
+ * \param ino Inode-Nummer der Datei
+ */
+static void devino_remove(devino_set_t *set, dev_t dev, ino_t ino) {
+    size_t mask = set->capacity - 1;
+    size_t i;
+
+    if (set->count == 0)
+        return;
+
+    for (i = devino_hash(dev, ino) & mask; set->slots[i].used; i = (i + 1) & mask) {
+        if (set->slots[i].dev == dev && set->slots[i].ino == ino)
+            break;
+    }
+    if (!set->slots[i].used)
+        return;
+
+    for (size_t j = (i + 1) & mask; set->slots[j].used; j = (j + 1) & mask) {
+        size_t home = devino_hash(set->slots[j].dev, set->slots[j].ino) & mask;
+
+        // move the entry into the hole unless its home lies cyclically between the hole and itself
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            set->slots[i] = set->slots[j];
+            i = j;
+        }
+    }
+
+    set->slots[i].used = false;
+    set->count--;
+}
+
+/**
+ * \brief Berechnet den Hash eines (st_dev, st_ino) Paares für devino_set_t
+ */
+static uint64_t devino_hash(dev_t dev, ino_t ino) {
+    uint64_t h = (uint64_t)ino * HASH_PRIME64_1 ^ (uint64_t)dev * HASH_PRIME64_2;
+
+    // inode numbers are often sequential, so mix the high bits into the low ones used as index
+    h ^= h >> 33;
+    h *= HASH_PRIME64_3;
+    h ^= h >> 29;
+    return h;
+}
+
+/**
+ * \brief Gibt die Tabelle eines devino_set_t frei.
+ *
+ * \param set freizugebendes Set
+ */
+static void devino_free(devino_set_t *set) {
+    free(set->slots);
+    set->slots = NULL;
+    set->count = 0;
+    set->capacity = 0;
+}
+
+/**
+ * \brief Rotiert einen 64-Bit Wert nach links
+ */
+static inline uint64_t hash_rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+/**
+ * \brief Verarbeitet einen 8-Byte Wert in einem Akkumulator (XXH64 round)
+ */
+static inline uint64_t hash_round(uint64_t acc, uint64_t input) {
+    acc += input * HASH_PRIME64_2;
+    acc = hash_rotl(acc, 31);
+    return acc * HASH_PRIME64_1;
+}
+
+/**
+ * \brief Liest einen 8-Byte Wert von einer beliebigen Adresse
+ */
+static inline uint64_t hash_read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * \brief Initialisiert einen Hash-Zustand (XXH64 mit Seed 0)
+ *
+ * \param state zu initialisierender Zustand
+ */
+static void hash_init(hash_state_t *state) {
+    memset(state, 0, sizeof(hash_state_t));
+    state->v[0] = HASH_PRIME64_1 + HASH_PRIME64_2;
+    state->v[1] = HASH_PRIME64_2;
+    state->v[2] = 0;
+    state->v[3] = -HASH_PRIME64_1;
+}
+
+/**
+ * \brief Fügt Daten zu einem Hash hinzu.
+ *
+ * Die Daten werden in Blöcken zu 32 Byte auf vier unabhängige Akkumulatoren verteilt,
+ * ein Rest wird bis zum nächsten Aufruf in state->mem gespeichert.
+ *
+ * \param state Hash-Zustand
+ * \param data zu hashende Daten
+ * \param len Länge der Daten
+ */
+static void hash_update(hash_state_t *state, const void *data, size_t len) {
+    const unsigned char *p = data;
+    const unsigned char *end = p + len;
+
+    state->total += len;
+
+    // fill up the remainder of the last call first
+    if (state->mem_size + len < sizeof(state->mem)) {
+        memcpy(state->mem + state->mem_size, p, len);
+        state->mem_size += len;
+        return;
+    }
+    if (state->mem_size > 0) {
+        size_t fill = sizeof(state->mem) - state->mem_size;
+        memcpy(state->mem + state->mem_size, p, fill);
+        for (int i = 0; i < 4; i++)
+            state->v[i] = hash_round(state->v[i], hash_read64(state->mem + i * 8));
+        p += fill;
+        state->mem_size = 0;
+    }
+
+    for (; p + sizeof(state->mem) <= end; p += sizeof(state->mem)) {
+        for (int i = 0; i < 4; i++)
+            state->v[i] = hash_round(state->v[i], hash_read64(p + i * 8));
+    }
+
+    state->mem_size = (size_t)(end - p);
+    memcpy(state->mem, p, state->mem_size);
+}
+
+/**
+ * \brief Berechnet den Hash-Wert aus dem aktuellen Zustand, der Zustand bleibt unverändert.
+ *
+ * \param state Hash-Zustand
+ *
+ * \return 64-Bit Hash-Wert
+ */
+static uint64_t hash_digest(const hash_state_t *state) {
+    const unsigned char *p = state->mem;
+    const unsigned char *end = p + state->mem_size;
+    uint64_t h;
+
+    if (state->total >= sizeof(state->mem)) {
+        h = hash_rotl(state->v[0], 1) + hash_rotl(state->v[1], 7) + hash_rotl(state->v[2], 12) +
+            hash_rotl(state->v[3], 18);
+        for (int i = 0; i < 4; i++) {
+            h ^= hash_round(0, state->v[i]);
+            h = h * HASH_PRIME64_1 + HASH_PRIME64_4;
+        }
+    } else {
+        h = HASH_PRIME64_5;
+    }
+    h += state->total;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= hash_round(0, hash_read64(p));
+        h = hash_rotl(h, 27) * HASH_PRIME64_1 + HASH_PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        h ^= (uint64_t)v * HASH_PRIME64_1;
+        h = hash_rotl(h, 23) * HASH_PRIME64_2 + HASH_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= *p * HASH_PRIME64_5;
+        h = hash_rotl(h, 11) * HASH_PRIME64_1;
+    }
+
+    // final avalanche
+    h ^= h >> 33;
+    h *= HASH_PRIME64_2;
+    h ^= h >> 29;
+    h *= HASH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * \brief Dient zum Ausgeben von benutzerfreundlichen Fehlermeldungen
+ *
+ * \param param parameter-struct des gerade bearbeiteten Arguments
+ * \param result gegebener ErrorCode der zu bearbeiten ist
+ *
+ * \func error() Wird nur mit (0, 0, ...) aufgerufen um einen exit-call zu vermeiden
+ */
+static void handle_error(const param_t *param, int result) {
+    const char *command = OPT_NAME[param->opt];
+
+    switch (result) {
+    case ERR_INVALID_ARGUMENT:
+        error(0, 0, "invalid argument '%s'", command);
+        break;
+    case ERR_VALUE_UNEXPECTED:
+        error(0, 0, "unexpected value '%s' on '%s'", param->value, command);
+        break;
+    case ERR_VALUE_MISSING:
+        error(0, 0, "missing value on '%s'", command);
+        break;
+    case ERR_INVALID_TYPE_ARGUMENT:
+        error(0, 0, "invalid type value '%s'", param->value);
+        break;
+    case ERR_NOT_IMPLEMENTED:
+        error(0, 0, "NOT IMPLEMENTED: can't unhandle command '%s'!", command);
+        break;
+    case ERR_OUTPUT_BROKEN:
+        error(0, 0, "can't write to stdout!");
+        break;
+    case ERR_NO_USER_FOUND:
+        error(0, 0, "Can't find user '%s'", param->value);
+        break;
+    case ERR_INVALID_PATTERN:
+        error(0, 0, "Pattern '%s' with code '%d'", param->value, result);
+        break;
+    case ERR_OUT_OF_MEMORY:
+        error(0, 0, "out of memory!");
+        break;
+    case ERR_INVALID_NUMBER:
+        error(0, 0, "invalid number '%s' on '%s'", param->value, command);
+        break;
+    case ERR_NO_REFERENCE_FILE:
+        error(0, errno, "can't get stat of reference file '%s'", param->value);
+        break;
+    default:
+        break;
+    }
+}
\ No newline at end of file
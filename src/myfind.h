@@ -0,0 +1,175 @@
+/**
+ * @file myfind.h
+ * Betriebssysteme MyFind
+ *
+ * Öffentliche Schnittstelle der Bibliothek libmyfind
+ *
+ * Die Bibliothek enthält die Traversierung und die Auswertung der Expression von MyFind.
+ * Eine Expression wird einmalig mit myfind_compile() übersetzt und kann danach beliebig oft
+ * auf Start-Verzeichnisse angewendet werden, entweder mit einem Callback (myfind_run()) oder
+ * mit einem Iterator (myfind_iter_open(), myfind_iter_next(), myfind_iter_close()). Die Varianten
+ * myfind_run_roots() und myfind_iter_open_roots() durchsuchen mehrere Start-Verzeichnisse in einem Durchlauf.
+ *
+ * Treffer sind alle Dateien, für die die Expression zutrifft und die ohne Ausgabe-Option
+ * implizit mit -print ausgegeben würden. Sie werden ohne Formatierung als Pfad und stat-Daten
+ * übergeben. Ausgabe-Optionen in der Expression (z.B. -ls, -exec) werden weiterhin ausgeführt.
+ *
+ * @author Baliko Markus	    <ic15b001@technikum-wien.at>
+ * @author Haubner Alexander    <ic15b033@technikum-wien.at>
+ * @author Riedmann Michael     <ic15b054@technikum-wien.at>
+ *
+ * @date 2016/03/18
+ *
+ * @version 2.0
+ *
+ */
+
+#ifndef MYFIND_H
+#define MYFIND_H
+
+// -------------------------------------------------------------- includes --
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------- typedefs --
+
+/**
+ *  \brief enum das alle möglichen Status-Codes der Applikation enthält.
+ *         Wird auch von Funktionen genützt um detailierte Fehlerinfos durchzureichen.
+ *         Die öffentlichen Namen tragen das Präfix MYFIND_, libmyfind selbst verwendet sie ohne Präfix.
+ */
+typedef enum {
+    // non error codes
+    MYFIND_OK_NOERROR = 0,         //!< Kein Fehler
+    MYFIND_OK_PROCEED = 1,         //!< mit Parameter-Verarbeitung vortfahren
+    MYFIND_OK_STOP = 2,            //!< Parameter-Verarbeitung abbrechen
+    MYFIND_OK_VALUE_NOTNEEDED = 3, //!< Keine zusetzliche Eingabe zu diesem Parameter notwendig
+    MYFIND_OK_VALUE_EXISTS = 4,    //!< Zusätzliche Eingabe zu diesem Parameter vorhanden
+    MYFIND_OK_DEFERRED = 5,        //!< Auswertung wird später fortgesetzt (z.B. nach -contains im Thread-Pool)
+
+    // error codes
+    MYFIND_ERR_NONCRITICAL = 0,            //!< Fehler der das Programm nicht anhält
+    MYFIND_ERR_TO0_FEW_ARGUMENTS = -1,     //!< Zu wenige Argumente übergeben
+    MYFIND_ERR_INVALID_ARGUMENT = -2,      //!< Ungültiges Argument übegeben
+    MYFIND_ERR_VALUE_UNEXPECTED = -3,      //!< Keine zusätzliche Eingabe erwartet aber erhalten
+    MYFIND_ERR_VALUE_MISSING = -4,         //!< Zusätzliche Eingabe erwartet aber keine erhalten
+    MYFIND_ERR_NO_USER_FOUND = -5,         //!< Übergabener Benutzer wurde nicht gefunden
+    MYFIND_ERR_OUTPUT_BROKEN = -6,         //!< Fehler bei der Ausgabe
+    MYFIND_ERR_INVALID_TYPE_ARGUMENT = -7, //!< Ungültiger Type eingegeben
+    MYFIND_ERR_INVALID_PATTERN = -8,       //!< Ungültiges Pattern eingegeben
+    MYFIND_ERR_OUT_OF_MEMORY = -9,         //!< Nicht genug Speicher vorhanden
+    MYFIND_ERR_INVALID_NUMBER = -10,       //!< Ungültige Zahl oder Einheit eingegeben
+    MYFIND_ERR_NO_REFERENCE_FILE = -11,    //!< Referenz-Datei kann nicht gelesen werden
+    MYFIND_ERR_EXEC_FAILED = -12,          //!< Ein -exec ... + Kommando ist fehlgeschlagen
+    MYFIND_ERR_NOT_IMPLEMENTED = -255,     //!< Noch nicht implementiert
+} myfind_retval_t;
+
+/**
+ * \brief Legt fest welchen symbolischen Links gefolgt wird
+ */
+typedef enum FOLLOW {
+    MYFIND_FOLLOW_NEVER = 0,  //!< symbolische Links werden nicht verfolgt (-P, Standard)
+    MYFIND_FOLLOW_ROOTS = 1,  //!< nur Start-Verzeichnisse die symbolische Links sind werden verfolgt (-H)
+    MYFIND_FOLLOW_ALWAYS = 2, //!< allen symbolischen Links wird gefolgt (-L)
+} myfind_follow_t;
+
+/**
+ * \brief Position der Ausgabe des Aufrufers, wird im Checkpoint gespeichert (siehe myfind_output_t)
+ */
+typedef struct MYFIND_POSITION {
+    uint64_t dev;   //!< Gerät der Ausgabe-Datei
+    uint64_t ino;   //!< Inode der Ausgabe-Datei
+    int64_t offset; //!< Position in der Ausgabe-Datei, -1 wenn es keine gibt (z.B. bei einer Pipe)
+} myfind_position_t;
+
+/**
+ * \brief Callback für die Ausgabe des Aufrufers bei --checkpoint und --resume
+ *
+ * Vor jedem Checkpoint (resume == false) sind alle Treffer davor abgegeben und alle Kommandos beendet. Der
+ * Callback schreibt dann seine Ausgabe vollständig und trägt deren Position ein. Beim Fortsetzen (resume == true)
+ * erhält er vor dem ersten Treffer die Position aus dem Checkpoint und kann die Ausgabe danach entfernen.
+ *
+ * \param position die Position der Ausgabe
+ * \param resume true beim Fortsetzen, false beim Schreiben eines Checkpoints
+ * \param data der Pointer output_data aus myfind_options_t
+ *
+ * \return 0 oder einen negativen Error-Code um die Traversierung mit diesem Fehler abzubrechen
+ */
+typedef int (*myfind_output_t)(myfind_position_t *position, bool resume, void *data);
+
+/**
+ * \brief Optionen die die Art der Traversierung beeinflussen
+ *
+ * Entspricht den Optionen des Programms vor dem Start-Verzeichnis.
+ * Die Standardwerte (options == NULL bei myfind_compile()) setzt myfind_options_init().
+ */
+typedef struct MYFIND_OPTIONS {
+    bool inode_order;           //!< Einträge eines Verzeichnisses in Inode-Reihenfolge lesen (lstat)
+    bool sort_name;             //!< Einträge eines Verzeichnisses in Namens-Reihenfolge verarbeiten
+    unsigned long jobs;         //!< maximale Anzahl gleichzeitig laufender Kommandos bzw. Threads, mindestens 1
+    int64_t content_max;        //!< maximale Dateigröße für -contains, 0 für unbegrenzt
+    myfind_follow_t follow;     //!< welchen symbolischen Links gefolgt wird
+    long du_depth;              //!< maximale Tiefe der Verzeichnisse die -du ausgibt, negativ für alle
+    bool parallel_roots;        //!< Start-Verzeichnisse auf verschiedenen Geräten gleichzeitig lesen
+    bool prefetch;              //!< Verzeichnisse und Inodes mit einem Hilfs-Thread in den Cache vorauslesen
+    const char *checkpoint;     //!< Datei in die regelmäßig die Position der Traversierung geschrieben wird oder NULL
+    const char *resume;         //!< Checkpoint-Datei an deren Position die Traversierung fortgesetzt wird oder NULL
+    unsigned long max_rate;     //!< maximale Anzahl verarbeiteter Einträge pro Sekunde, 0 für unbegrenzt
+    unsigned long max_dir_rate; //!< maximale Anzahl gelesener Verzeichnisse pro Sekunde, 0 für unbegrenzt
+    long backoff_latency;       //!< Lesezeit eines Verzeichnisses in ms ab der die Traversierung ausweicht, 0 für nie
+    bool stats;                 //!< Anzahl, Raten und Wartezeiten der Traversierung am Ende auf stderr ausgeben
+    myfind_output_t output;     //!< hält die Position der Ausgabe in Checkpoints fest oder NULL für keine
+    void *output_data;          //!< wird an output übergeben
+} myfind_options_t;
+
+/**
+ * \brief Eine übersetzte Expression (siehe myfind_compile())
+ */
+typedef struct EXPRESSION myfind_expr_t;
+
+/**
+ * \brief Ein Iterator über die Treffer einer Traversierung (siehe myfind_iter_open())
+ */
+typedef struct MYFIND_ITER myfind_iter_t;
+
+/**
+ * \brief Callback für myfind_run(), wird für jeden Treffer aufgerufen
+ *
+ * \param path Pfad der Datei, nur während des Aufrufs gültig
+ * \param file_stat metadaten der Datei, nur während des Aufrufs gültig
+ * \param data der an myfind_run() übergebene Pointer
+ *
+ * \return 0 um fortzufahren, > 0 um die Traversierung ohne Fehler zu beenden
+ *         oder einen negativen Error-Code um sie mit diesem Fehler abzubrechen
+ */
+typedef int (*myfind_callback_t)(const char *path, const struct stat *file_stat, void *data);
+
+// -------------------------------------------------------------- prototypes --
+void myfind_options_init(myfind_options_t *options);
+
+myfind_retval_t myfind_compile(const char *const *args, const myfind_options_t *options, myfind_expr_t **expr);
+void myfind_free(myfind_expr_t *expr);
+
+myfind_retval_t myfind_run(myfind_expr_t *expr, const char *root, myfind_callback_t callback, void *data);
+myfind_retval_t myfind_run_roots(myfind_expr_t *expr, const char *const *roots, size_t count,
+                                 myfind_callback_t callback, void *data);
+
+myfind_retval_t myfind_iter_open(myfind_expr_t *expr, const char *root, myfind_iter_t **iter);
+myfind_retval_t myfind_iter_open_roots(myfind_expr_t *expr, const char *const *roots, size_t count,
+                                       myfind_iter_t **iter);
+myfind_retval_t myfind_iter_next(myfind_iter_t *iter, const char **path, const struct stat **file_stat);
+myfind_retval_t myfind_iter_close(myfind_iter_t *iter);
+
+myfind_retval_t myfind_parse_size(const char *value, int64_t *size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MYFIND_H
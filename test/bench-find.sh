@@ -0,0 +1,79 @@
+#!/bin/bash --norc
+#
+# Benchmarks myfind traversal variants on a given directory.
+#
+# Every variant runs with a cold page/dentry/inode cache (requires root for
+# /proc/sys/vm/drop_caches, otherwise the runs are warm and a warning is shown).
+#
+
+set -u          # terminate on uninitialized variables
+
+MYFIND=./myfind
+BENCHDIR=/var/tmp/test-find/full
+RUNS=3
+
+function show_usage() {
+    echo "USAGE: $0 [-h] [-t <path_to_myfind>] [-d <directory>] [-n <runs>]" >& 2
+    echo "           -h: show this help" >& 2
+    echo "           -t: myfind binary to benchmark (default: ${MYFIND})" >& 2
+    echo "           -d: directory to scan (default: ${BENCHDIR})" >& 2
+    echo "           -n: runs per variant (default: ${RUNS})" >& 2
+}
+
+function drop_caches() {
+    sync
+    if ! echo 3 > /proc/sys/vm/drop_caches 2>/dev/null; then
+        echo "$0: can't drop caches - results are warm-cache numbers" >&2
+    fi
+}
+
+# bench <label> <myfind options...>
+function bench() {
+    local -r label="$1"
+    shift
+    local total=0 start end
+
+    for (( run = 0; run < RUNS; run++ )); do
+        drop_caches
+        start=$(date +%s%N)
+        "$MYFIND" "$@" "$BENCHDIR" > /dev/null 2>&1
+        end=$(date +%s%N)
+        (( total += (end - start) / 1000000 ))
+    done
+
+    printf "%-30s %8d ms (avg of %d cold runs)\n" "$label" $(( total / RUNS )) "$RUNS"
+}
+
+while getopts "ht:d:n:" opt; do
+    case "$opt" in
+    h)
+        show_usage
+        exit 0
+        ;;
+    t)
+        MYFIND="$OPTARG"
+        ;;
+    d)
+        BENCHDIR="$OPTARG"
+        ;;
+    n)
+        RUNS="$OPTARG"
+        ;;
+    *)
+        show_usage
+        exit 1
+        ;;
+    esac
+done
+
+if [ ! -x "$MYFIND" ] || [ ! -d "$BENCHDIR" ]; then
+    show_usage
+    exit 1
+fi
+
+bench "readdir order"
+bench "inode order" --inode-order
+bench "name order" --sort-name
+bench "inode order, name output" --inode-order --sort-name
+bench "readdir order, prefetch" --prefetch
+bench "inode order, prefetch" --inode-order --prefetch
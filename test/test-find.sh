@@ -18,6 +18,8 @@ set -u          # terminate on uninitialized variables
 
 # the known correct program
 KNOWN_CORRECT_FIND=/usr/local/bin/bic-myfind
+# the reference for the extensions the known correct program does not know
+GNU_FIND=/usr/bin/find
 # guess what ...
 QUIET=0
 VERBOSE=0
@@ -50,12 +52,13 @@ TOUSEDIR=${SIMPLEDIR}
 #
 
 function show_usage() {
-    echo "USAGE: $0 [-h]  [-q] [-v] [-f] [-c] [--color (auto|always|never)] [-t <path_to_the_to_be_tested_find>] [-r <path_to_the_known_correct_reference_find>]" >& 2
+    echo "USAGE: $0 [-h]  [-q] [-v] [-f] [-c] [--color (auto|always|never)] [-t <path_to_the_to_be_tested_find>] [-r <path_to_the_known_correct_reference_find>] [-g <path_to_gnu_find>]" >& 2
     echo "           -h: show this help" >& 2
     echo "           -q: do not show successful test results" >& 2
     echo "           -v: show a lot - probably only useful to debug the test script itself" >& 2
     echo "           -c: continue after failed tests" >& 2
     echo "           -f: use ${FULLDIR} instead of ${SIMPLEDIR} as test directory" >& 2
+    echo "           -g: use this GNU find as reference for the extensions (default ${GNU_FIND})" >& 2
     echo "           --color: auto-detect, force or cease coloring" >& 2
 }
 
@@ -101,7 +104,7 @@ function verbose() {
 #
 # ------------------------------------------------------------------------------------- process args ---
 #
-readonly SHORT_OPTS="hvqt:r:cf"
+readonly SHORT_OPTS="hvqt:r:g:cf"
 readonly LONG_OPTS="help,color:"
 # print nothing and just check for errors terminating the script 
 
@@ -146,6 +149,11 @@ while [ "$#" -gt 0 ]; do
         echo "$0: Using known-correct reference binary \"$KNOWN_CORRECT_FIND\""
         shift 2
         ;;
+    -g)
+        GNU_FIND="$2"
+        echo "$0: Using GNU find reference binary \"$GNU_FIND\""
+        shift 2
+        ;;
     --color)
         COLOR="$2"
         shift 2
@@ -195,6 +203,15 @@ else
     show_usage
     exit 1
 fi
+
+if [ -e "$GNU_FIND" ]
+then
+    echo "$0: Using GNU find reference binary \"$GNU_FIND\""
+else
+    echo "$0: Cannot find GNU find reference binary \"$GNU_FIND\"" >&2
+    show_usage
+    exit 1
+fi
 case "$COLOR" in
     auto)
         if ! [ -t 1 ]; then # no colors if stdout is not on a tty
@@ -218,7 +235,7 @@ case "$COLOR" in
         exit 1
         ;;
 esac
-readonly TO_BE_TESTED_FIND KNOWN_CORRECT_FIND QUIET VERBOSE
+readonly TO_BE_TESTED_FIND KNOWN_CORRECT_FIND GNU_FIND QUIET VERBOSE
 readonly EMPH_ON EMPH_SUCCESS EMPH_FAILED EMPH_OFF
 
 #
@@ -471,6 +488,321 @@ do
   done
 done
 
+# ------------------------------------------------------------------------------------------------------
+echo -e "${EMPH_ON}----- Test 5.0: Test the extensions against GNU find ----${EMPH_OFF}"
+
+# the extensions need file contents, time stamps and symbolic links which the test environment
+# does not have, so they run on a tree of their own
+readonly EXTDIR=`mktemp -d /tmp/test-find-ext.XXXXXXXXXX`
+mkdir -p "$EXTDIR/tree/a/sub" "$EXTDIR/tree/b"
+printf 'needle\n'         > "$EXTDIR/tree/a/one.txt"
+printf 'hay\n'            > "$EXTDIR/tree/a/two.TXT"
+printf 'hay needle hay\n' > "$EXTDIR/tree/b/three.c"
+head -c 10000 /dev/zero   > "$EXTDIR/tree/b/big"
+printf 'hours\n'          > "$EXTDIR/tree/b/hours"
+printf 'days\n'           > "$EXTDIR/tree/b/days"
+# away from whole minutes and days, GNU find allows one second more for -mtime -n
+touch -d '7230 seconds ago' "$EXTDIR/tree/b/hours"
+touch -d '73 hours ago' "$EXTDIR/tree/b/days"
+touch -d 1999-01-01 "$EXTDIR/tree/a/two.TXT"
+touch -d 2000-01-01 "$EXTDIR/old-reference"
+printf 'same content\n'   > "$EXTDIR/tree/a/sub/dup1"
+printf 'same content\n'   > "$EXTDIR/tree/b/dup2"
+printf 'SAME CONTENT\n'   > "$EXTDIR/tree/b/same-size"
+ln -s old-reference "$EXTDIR/reference-link"
+touch -h -d 2030-01-01 "$EXTDIR/reference-link"
+ln -s a "$EXTDIR/tree/lnk"
+ln -s ../b "$EXTDIR/tree/a/back"
+ln -s tree "$EXTDIR/root-link"
+# --parallel-roots only starts a thread per device, so there is a copy of the tree on another file system
+readonly OTHERDIR=`mktemp -d /dev/shm/test-find-ext.XXXXXXXXXX 2> /dev/null || mktemp -d /tmp/test-find-ext.XXXXXXXXXX`
+cp -a "$EXTDIR/tree" "$OTHERDIR"
+
+# the arguments for GNU find follow the ones for the to-be-tested find after "--", without "--" both get the same
+function test_gnu()
+{
+    local -a tested=()
+    while [ "$#" -gt 0 -a "${1:-}" != "--" ]
+    do
+        tested+=("$1")
+        shift
+    done
+    if [ "$#" -gt 0 ]
+    then
+        shift
+    else
+        set -- "${tested[@]}"
+    fi
+
+    run_command "$CORRECT_STDOUT" "$CORRECT_STDERR" "$GNU_FIND" "$@"
+    local -r findrc="$?"
+
+    run_command "$TESTED_STDOUT" "$TESTED_STDERR" "$TO_BE_TESTED_FIND" "${tested[@]}"
+    local -r myfindrc="$?"
+
+    if [ "$findrc" -eq "0" -a "$myfindrc" -eq "0" ] || [ "$findrc" -ne "0" -a "$myfindrc" -ne "0" ]
+    then
+        sort < "$CORRECT_STDOUT" > "$CORRECT_STDOUT_SORTED"
+        sort < "$TESTED_STDOUT"  > "$TESTED_STDOUT_SORTED"
+
+        diff_files "$CORRECT_STDOUT_SORTED" "$TESTED_STDOUT_SORTED" "${tested[@]}"
+    else
+        failed "The return values for \"${tested[@]}\" are not equivalent - $findrc vs $myfindrc."
+    fi
+}
+
+# with --sort-name the output has to be in the order of the sorted output of GNU find,
+# which gets the same arguments without the long options only the to-be-tested find knows
+function test_sort_name()
+{
+    local -a gnu=()
+    local arg
+    for arg in "$@"
+    do
+        if [ "${arg#--}" = "$arg" ]
+        then
+            gnu+=("$arg")
+        fi
+    done
+
+    run_command "$CORRECT_STDOUT" "$CORRECT_STDERR" "$GNU_FIND" "${gnu[@]}"
+    run_command "$TESTED_STDOUT" "$TESTED_STDERR" "$TO_BE_TESTED_FIND" --sort-name "$@"
+    LC_ALL=C sort < "$CORRECT_STDOUT" > "$CORRECT_STDOUT_SORTED"
+    diff_files "$CORRECT_STDOUT_SORTED" "$TESTED_STDOUT" --sort-name "$@"
+}
+
+# options come before the start directory, so test_param can't check them
+function test_option()
+{
+    verbose "${TO_BE_TESTED_FIND}" "$@" "$EXTDIR/tree"
+    if "${TO_BE_TESTED_FIND}" "$@" "$EXTDIR/tree" >&/dev/null </dev/null
+    then
+        failed "No exit code indicating failure when calling ${TO_BE_TESTED_FIND} with the option \"$@\""
+    else
+        success "Exit code indicating failure when calling ${TO_BE_TESTED_FIND} with the option \"$@\""
+    fi
+}
+
+# the first argument is the expected output, in this order
+function test_expected()
+{
+    local -r expected="$1"
+    shift
+
+    run_command "$TESTED_STDOUT" "$TESTED_STDERR" "$TO_BE_TESTED_FIND" "$@"
+    local -r myfindrc="$?"
+    if [ "$myfindrc" -ne "0" ]
+    then
+        failed "The return value for \"$@\" is $myfindrc instead of 0."
+    fi
+    printf '%s\n' "$expected" > "$CORRECT_STDOUT"
+    diff_files "$CORRECT_STDOUT" "$TESTED_STDOUT" "$@"
+}
+
+# the sizes of -du are compared with du -k, the largest directory has to come first,
+# the optional second argument are the expected file counts sorted by path
+function test_du()
+{
+    local -r depth="$1"
+
+    run_command "$CORRECT_STDOUT" "$CORRECT_STDERR" du -k --max-depth="$depth" "$EXTDIR/tree"
+    run_command "$TESTED_STDOUT" "$TESTED_STDERR" "$TO_BE_TESTED_FIND" --du-depth "$depth" "$EXTDIR/tree" -du
+    if ! sort -c -s -n -r -k 1,1 "$TESTED_STDOUT" 2> /dev/null
+    then
+        failed "The output for \"--du-depth $depth $EXTDIR/tree -du\" is not sorted by size."
+    fi
+    sort -k 2 < "$CORRECT_STDOUT" > "$CORRECT_STDOUT_SORTED"
+    cut -f 1,3 < "$TESTED_STDOUT" | sort -k 2 > "$TESTED_STDOUT_SORTED"
+    diff_files "$CORRECT_STDOUT_SORTED" "$TESTED_STDOUT_SORTED" --du-depth "$depth" "$EXTDIR/tree" -du
+    if [ "$#" -gt 1 ]
+    then
+        printf '%s\n' "$2" > "$CORRECT_STDOUT_SORTED"
+        cut -f 2,3 < "$TESTED_STDOUT" | sort -k 2 > "$TESTED_STDOUT_SORTED"
+        diff_files "$CORRECT_STDOUT_SORTED" "$TESTED_STDOUT_SORTED" --du-depth "$depth" "$EXTDIR/tree" -du "(file counts)"
+    fi
+}
+
+# --prefetch must not change the output, with --parallel-roots the order of the start directories may mix
+function test_prefetch()
+{
+    run_command "$CORRECT_STDOUT" "$CORRECT_STDERR" "$TO_BE_TESTED_FIND" "$@"
+    run_command "$TESTED_STDOUT" "$TESTED_STDERR" "$TO_BE_TESTED_FIND" --prefetch "$@"
+    if [ "$1" = "--parallel-roots" ]
+    then
+        sort < "$CORRECT_STDOUT" > "$CORRECT_STDOUT_SORTED"
+        sort < "$TESTED_STDOUT"  > "$TESTED_STDOUT_SORTED"
+        diff_files "$CORRECT_STDOUT_SORTED" "$TESTED_STDOUT_SORTED" --prefetch "$@"
+    else
+        diff_files "$CORRECT_STDOUT" "$TESTED_STDOUT" --prefetch "$@"
+    fi
+}
+
+# --inode-order only changes the order of the stat calls, not which entries are found
+test_gnu --inode-order "$EXTDIR/tree" -- "$EXTDIR/tree"
+test_gnu --inode-order "$EXTDIR/tree" -type f -name '*.c' -- "$EXTDIR/tree" -type f -name '*.c'
+test_sort_name "$EXTDIR/tree"
+test_sort_name --inode-order "$EXTDIR/tree"
+
+# -size rounds up to the unit, -mtime and -mmin compare the age in whole days and minutes
+for size in +9k 10k -10k 20 +19 -2 10000c -1M +0 1 -1 +1 1k -1k
+do
+    test_gnu "$EXTDIR/tree" -size "$size"
+done
+for days in 0 -1 +0 3 -3 -4 +2 +3
+do
+    test_gnu "$EXTDIR/tree" -mtime "$days"
+done
+for minutes in -60 +60 120 121 -121 +120 +121
+do
+    test_gnu "$EXTDIR/tree" -mmin "$minutes"
+done
+test_gnu "$EXTDIR/tree" -newer "$EXTDIR/old-reference"
+test_gnu "$EXTDIR/tree" -type f -size -2 -newer "$EXTDIR/old-reference" -mmin +1
+
+# -exec ... {} + may split the paths into several calls, so only the sorted output is comparable
+test_gnu "$EXTDIR/tree" -exec echo {} \;
+test_gnu "$EXTDIR/tree" -type f -exec printf '%s\n' {} +
+test_gnu -j 4 "$EXTDIR/tree" -exec echo found {} \; -- "$EXTDIR/tree" -exec echo found {} \;
+test_gnu -j 4 "$EXTDIR/tree" -type f -exec printf '%s\n' {} + -- "$EXTDIR/tree" -type f -exec printf '%s\n' {} +
+test_gnu "$EXTDIR/tree" -type f -exec false \;
+test_gnu "$EXTDIR/tree" -exec printf '%s\n' {} {} +
+test_gnu "$EXTDIR/tree" -exec printf '%s\n' x{} +
+test_param -exec printf '%s\n' {}
+# like GNU find a failed -exec ... {} + only shows up in the exit status
+verbose "$TO_BE_TESTED_FIND" "$EXTDIR/tree" -type f -exec false {} +
+if "$TO_BE_TESTED_FIND" "$EXTDIR/tree" -type f -exec false {} + >& /dev/null < /dev/null
+then
+    failed "No exit code indicating failure when a command of \"-exec false {} +\" fails"
+else
+    success "Exit code indicating failure when a command of \"-exec false {} +\" fails"
+fi
+test_option -j 0
+test_option -j 1025
+test_option -j 99999999999999999999999
+
+# -contains is compared with grep on every regular file
+test_gnu "$EXTDIR/tree" -contains needle -- "$EXTDIR/tree" -type f -exec grep -q needle {} \; -print
+test_gnu -j 4 "$EXTDIR/tree" -contains hay -- "$EXTDIR/tree" -type f -exec grep -q hay {} \; -print
+test_gnu "$EXTDIR/tree" -contains '' -- "$EXTDIR/tree" -type f
+test_gnu --max-content-size 10 "$EXTDIR/tree" -contains needle -- \
+    "$EXTDIR/tree" -type f -size -11c -exec grep -q needle {} \; -print
+test_param -contains
+test_option --max-content-size 10x
+
+# same-size has the size of the duplicates but other contents
+test_expected "$(printf '%s\n' "$EXTDIR/tree/a/sub/dup1" "$EXTDIR/tree/b/dup2")" --sort-name "$EXTDIR/tree" -dupes
+test_expected "$(printf '%s\n' "$EXTDIR/tree/a/sub/dup1" "$EXTDIR/tree/b/dup2")" -j 4 --sort-name "$EXTDIR/tree" -dupes
+test_param -dupes so-nicht
+
+# -H follows the start directories and the reference of -newer, -L every symbolic link
+test_gnu "$EXTDIR/tree" -newer "$EXTDIR/reference-link"
+test_gnu -H "$EXTDIR/tree" -newer "$EXTDIR/reference-link"
+test_gnu -L "$EXTDIR/tree" -newer "$EXTDIR/reference-link"
+test_gnu "$EXTDIR/root-link"
+test_gnu -H "$EXTDIR/root-link"
+test_gnu -L "$EXTDIR/root-link"
+test_gnu -H "$EXTDIR/root-link" -type l
+test_gnu -L "$EXTDIR/tree" -type f
+test_gnu -L "$EXTDIR/tree" -type l
+test_sort_name -L "$EXTDIR/tree"
+
+test_du 0
+test_du 1
+test_du 3 "$(printf '%s\t%s\n' 11 "$EXTDIR/tree" 4 "$EXTDIR/tree/a" 1 "$EXTDIR/tree/a/sub" 6 "$EXTDIR/tree/b")"
+test_option --du-depth -1
+
+# a start directory given twice is traversed twice, like GNU find does
+test_gnu "$EXTDIR/tree/a" "$EXTDIR/tree/b" "$EXTDIR/tree/a" -name one.txt
+test_gnu "$EXTDIR/tree/a" "$EXTDIR/tree/b" "$EXTDIR/tree/a"
+test_gnu "$EXTDIR/tree" "$OTHERDIR/tree" -type f
+test_gnu --parallel-roots "$EXTDIR/tree/a" "$OTHERDIR/tree" "$EXTDIR/tree/b" "$EXTDIR/tree/a" -- \
+    "$EXTDIR/tree/a" "$OTHERDIR/tree" "$EXTDIR/tree/b" "$EXTDIR/tree/a"
+test_gnu --parallel-roots "$EXTDIR/tree" "$OTHERDIR/tree" -name '*.txt' -- "$EXTDIR/tree" "$OTHERDIR/tree" -name '*.txt'
+test_gnu --parallel-roots -L "$EXTDIR/root-link" "$OTHERDIR/tree" -type f -- -L "$EXTDIR/root-link" "$OTHERDIR/tree" -type f
+
+test_gnu --prefetch "$EXTDIR/tree" -- "$EXTDIR/tree"
+test_gnu --prefetch -L "$EXTDIR/tree" -type f -- -L "$EXTDIR/tree" -type f
+test_prefetch --sort-name "$EXTDIR/tree"
+test_prefetch --sort-name -L "$EXTDIR/tree" "$OTHERDIR/tree"
+test_prefetch --parallel-roots --sort-name "$EXTDIR/tree" "$OTHERDIR/tree"
+test_prefetch --parallel-roots --sort-name --inode-order "$EXTDIR/tree" "$OTHERDIR/tree" -type f
+
+# only patterns that mean the same as ERE and as the emacs syntax of GNU find
+test_gnu "$EXTDIR/tree" -regex '.*/[a-z]+\.txt'
+test_gnu "$EXTDIR/tree" -iregex '.*\.txt'
+test_gnu "$EXTDIR/tree" -regex '.*/tree/a/.*' -type f
+test_gnu "$EXTDIR/tree" -regex 'one.txt'
+test_gnu "$EXTDIR/tree" -iregex '.*/[A-Z]*[0-9]'
+test_param -regex '['
+
+# -quit and -limit end the traversal, so the order matters for which entries are printed
+test_gnu "$EXTDIR/tree" -name one.txt -print -quit
+test_gnu "$EXTDIR/tree" -name one.txt -exec printf '%s\n' {} + -quit
+test_expected "$(printf '%s\n' "$EXTDIR/tree" "$EXTDIR/tree/a" "$EXTDIR/tree/a/back")" --sort-name "$EXTDIR/tree" -limit 3
+test_expected "$(printf '%s\n' "$EXTDIR/tree/a/back" "$EXTDIR/tree/a/one.txt")" --sort-name "$EXTDIR/tree" \
+    -path "$EXTDIR/tree/a/*" -limit 2
+test_param -limit 0
+test_param -limit -1
+
+# the limits only slow the traversal down
+test_gnu --max-rate 1000 "$EXTDIR/tree" -- "$EXTDIR/tree"
+test_gnu --max-dir-rate 1000 "$EXTDIR/tree" -- "$EXTDIR/tree"
+test_gnu --backoff-latency 1 "$EXTDIR/tree" -- "$EXTDIR/tree"
+test_gnu --ionice idle "$EXTDIR/tree" -- "$EXTDIR/tree"
+for option in "--ionice bogus" "--ionice best-effort:8" "--ionice idle:3" "--max-rate 0x" "--max-rate 0" \
+              "--max-dir-rate -1" "--max-dir-rate 99999999999999999999999" "--backoff-latency 0" \
+              "--backoff-latency 10ms"
+do
+    test_option $option
+done
+# --stats counts every entry, not only the ones printed
+verbose "$TO_BE_TESTED_FIND" --stats "$EXTDIR/tree" -name one.txt
+"$TO_BE_TESTED_FIND" --stats "$EXTDIR/tree" -name one.txt > "$TESTED_STDOUT" 2> "$TESTED_STDERR"
+entries=`sed -n 's/^ *entries *\([0-9]*\) .*$/\1/p' "$TESTED_STDERR"`
+expected=`"$GNU_FIND" "$EXTDIR/tree" | count_lines`
+if [ "$entries" = "$expected" ]
+then
+    success "The entry count of \"--stats $EXTDIR/tree -name one.txt\" is $expected."
+else
+    failed "The entry count of \"--stats $EXTDIR/tree -name one.txt\" is \"$entries\" instead of $expected."
+fi
+
+# ------------------------------------------------------------------------------------------------------
+echo -e "${EMPH_ON}----- Test 5.1: Test an interrupted and resumed traversal ----${EMPH_OFF}"
+
+mkdir -p "$EXTDIR/resume"
+
+# the first checkpoint is written after 10 seconds, at 25 entries per second about 250 of the 400 files are done
+for i in `seq -w 1 400`
+do
+    : > "$EXTDIR/resume/f$i"
+done
+"$TO_BE_TESTED_FIND" --sort-name "$EXTDIR/resume" > "$CORRECT_STDOUT"
+"$TO_BE_TESTED_FIND" --checkpoint "$EXTDIR/checkpoint" --max-rate 25 "$EXTDIR/resume" > "$TESTED_STDOUT" &
+sleep 12
+kill "$!"
+wait "$!"
+if [ ! -s "$EXTDIR/checkpoint" ]
+then
+    failed "No checkpoint written by --checkpoint within 12 seconds"
+elif [ `count_lines < "$TESTED_STDOUT"` -ge 401 ]
+then
+    failed "The traversal with --max-rate 25 finished before it was interrupted"
+else
+    # the resumed traversal removes what was printed after the checkpoint, so it has to append to the same file
+    verbose "$TO_BE_TESTED_FIND" --checkpoint "$EXTDIR/checkpoint" --resume "$EXTDIR/checkpoint" "$EXTDIR/resume"
+    if ! "$TO_BE_TESTED_FIND" --checkpoint "$EXTDIR/checkpoint" --resume "$EXTDIR/checkpoint" "$EXTDIR/resume" >> "$TESTED_STDOUT" 2> "$TESTED_STDERR"
+    then
+        failed "The resumed traversal failed"
+    elif [ -s "$TESTED_STDERR" ]
+    then
+        failed "The resumed traversal succeeded but data on stderr in $TESTED_STDERR."
+    fi
+    diff_files "$CORRECT_STDOUT" "$TESTED_STDOUT" --checkpoint "$EXTDIR/checkpoint" --resume "$EXTDIR/checkpoint" "$EXTDIR/resume"
+fi
+
+rm -rf "$EXTDIR" "$OTHERDIR"
+
 exit 0
 # the below is untested ....
 fi
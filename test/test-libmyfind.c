@@ -0,0 +1,305 @@
+/**
+ * @file test-libmyfind.c
+ * Betriebssysteme MyFind
+ *
+ * Test der Schnittstelle von libmyfind
+ *
+ * Legt einen kleinen Verzeichnisbaum an, übersetzt mehrere Expressions und prüft, dass der Iterator
+ * (myfind_iter_open_roots(), myfind_iter_next()) dieselben Pfade in derselben Reihenfolge liefert wie
+ * der Callback von myfind_run_roots() und dass diese den erwarteten Treffern entsprechen.
+ *
+ * @author Baliko Markus	    <ic15b001@technikum-wien.at>
+ * @author Haubner Alexander    <ic15b033@technikum-wien.at>
+ * @author Riedmann Michael     <ic15b054@technikum-wien.at>
+ *
+ * @date 2016/03/18
+ *
+ * @version 2.0
+ *
+ */
+
+// -------------------------------------------------------------- includes --
+#include "myfind.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// -------------------------------------------------------------- defines --
+#define PATH_MAX_TEST 4096
+#define MATCHES_MAX 64
+
+// -------------------------------------------------------------- typedefs --
+
+/**
+ * \brief Gesammelte Pfade einer Traversierung
+ */
+typedef struct {
+    char *paths[MATCHES_MAX]; //!< die Pfade in der Reihenfolge der Abgabe
+    size_t count;             //!< Anzahl der Pfade
+} matches_t;
+
+/**
+ * \brief Ein Testfall: Expression, Optionen und die erwarteten Treffer
+ */
+typedef struct {
+    const char *args[4];      //!< Expression-Argumente (NULL-terminiert)
+    bool sort_name;           //!< Einträge in Namens-Reihenfolge verarbeiten
+    unsigned long jobs;       //!< Anzahl der Threads für -contains
+    const char *expected[8];  //!< erwartete Treffer relativ zum Baum in Namens-Reihenfolge (NULL-terminiert)
+} test_case_t;
+
+// -------------------------------------------------------------- prototypes --
+static bool make_tree(const char *dir);
+static void remove_tree(const char *dir);
+static int collect(const char *path, const struct stat *file_stat, void *data);
+static void matches_free(matches_t *matches);
+static bool run_case(const test_case_t *test, const char *dir);
+static bool check_expected(const test_case_t *test, const char *dir, const matches_t *matches);
+static int compare_paths(const void *a, const void *b);
+
+// -------------------------------------------------------------- constants --
+
+/**
+ * \brief Dateien und Verzeichnisse des Testbaums, Verzeichnisse enden mit '/'
+ */
+static const char *const TREE[] = {"a/", "a/one.c", "a/two.txt", "a/sub/", "a/sub/three.c", "b/", "b/four.c",
+                                   "b/five.TXT", NULL};
+
+/**
+ * \brief Die Testfälle, Pfade ohne führendes Start-Verzeichnis
+ */
+static const test_case_t TESTS[] = {
+    {{"-name", "*.c", NULL}, false, 1, {"a/one.c", "a/sub/three.c", "b/four.c", NULL}},
+    {{"-name", "*.c", NULL}, true, 1, {"a/one.c", "a/sub/three.c", "b/four.c", NULL}},
+    {{"-type", "d", NULL}, true, 1, {"", "a", "a/sub", "b", NULL}},
+    {{"-path", "*/a/*", NULL}, false, 1, {"a/one.c", "a/sub", "a/sub/three.c", "a/two.txt", NULL}},
+    {{"-contains", "needle", NULL}, true, 4, {"a/one.c", "b/five.TXT", NULL}},
+    {{"-name", "nothing", NULL}, false, 1, {NULL}},
+};
+
+// -------------------------------------------------------------- functions --
+
+/**
+ * \brief Programm Einstiegspunkt.
+ *
+ * \func make_tree() legt den Testbaum in einem temporären Verzeichnis an
+ * \func run_case() führt einen Testfall aus
+ *
+ * \return EXIT_SUCCESS wenn alle Testfälle erfolgreich waren, sonst EXIT_FAILURE
+ */
+int main(void) {
+    char dir[] = "/tmp/test-libmyfind.XXXXXX";
+    size_t failed = 0;
+
+    if (mkdtemp(dir) == NULL || !make_tree(dir)) {
+        perror("test-libmyfind: can't create the test tree");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < sizeof(TESTS) / sizeof(TESTS[0]); i++) {
+        bool ok = run_case(&TESTS[i], dir);
+        printf("%s: %s %s%s\n", ok ? "ok" : "FAILED", TESTS[i].args[0], TESTS[i].args[1],
+               TESTS[i].sort_name ? " (sort-name)" : "");
+        failed += !ok;
+    }
+
+    remove_tree(dir);
+    printf("%lu of %lu tests failed\n", (unsigned long)failed, (unsigned long)(sizeof(TESTS) / sizeof(TESTS[0])));
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * \brief Legt die Dateien und Verzeichnisse aus TREE an.
+ *
+ * Die Dateien one.c und five.TXT enthalten "needle" für -contains.
+ *
+ * \param dir das temporäre Verzeichnis
+ *
+ * \return true wenn erfolgreich
+ */
+static bool make_tree(const char *dir) {
+    char path[PATH_MAX_TEST];
+
+    for (size_t i = 0; TREE[i] != NULL; i++) {
+        size_t len = strlen(TREE[i]);
+        snprintf(path, sizeof(path), "%s/%s", dir, TREE[i]);
+        if (TREE[i][len - 1] == '/') {
+            if (mkdir(path, 0755) == -1)
+                return false;
+            continue;
+        }
+
+        FILE *fp = fopen(path, "w");
+        if (fp == NULL)
+            return false;
+        bool needle = (strstr(TREE[i], "one.c") != NULL || strstr(TREE[i], "five") != NULL);
+        fprintf(fp, "%s\n", needle ? "a needle in a haystack" : "just hay");
+        if (fclose(fp) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Entfernt den Testbaum, in umgekehrter Reihenfolge von TREE.
+ *
+ * \param dir das temporäre Verzeichnis
+ */
+static void remove_tree(const char *dir) {
+    char path[PATH_MAX_TEST];
+    size_t count = 0;
+
+    while (TREE[count] != NULL)
+        count++;
+    while (count-- > 0) {
+        snprintf(path, sizeof(path), "%s/%s", dir, TREE[count]);
+        (void)remove(path);
+    }
+    (void)rmdir(dir);
+}
+
+/**
+ * \brief Sammelt einen Treffer, Callback für myfind_run_roots()
+ *
+ * \param path Pfad der Datei
+ * \param file_stat metadaten der Datei (nicht verwendet)
+ * \param data die matches_t in die gesammelt wird
+ *
+ * \return 0 bei Erfolg, sonst MYFIND_ERR_OUT_OF_MEMORY
+ */
+static int collect(const char *path, const struct stat *file_stat, void *data) {
+    matches_t *matches = data;
+    (void)file_stat;
+
+    if (matches->count == MATCHES_MAX || (matches->paths[matches->count] = strdup(path)) == NULL)
+        return MYFIND_ERR_OUT_OF_MEMORY;
+    matches->count++;
+    return 0;
+}
+
+/**
+ * \brief Gibt die gesammelten Pfade frei
+ *
+ * \param matches die gesammelten Pfade
+ */
+static void matches_free(matches_t *matches) {
+    for (size_t i = 0; i < matches->count; i++)
+        free(matches->paths[i]);
+    matches->count = 0;
+}
+
+/**
+ * \brief Führt einen Testfall mit dem Callback und mit dem Iterator aus und vergleicht die Pfade.
+ *
+ * Die Expression wird einmal übersetzt und für beide Durchläufe verwendet.
+ *
+ * \param test der Testfall
+ * \param dir das Start-Verzeichnis
+ *
+ * \func myfind_run_roots() liefert die Treffer an collect()
+ * \func myfind_iter_next() liefert die Treffer einzeln, bis OK_STOP
+ * \func check_expected() vergleicht die Treffer mit den erwarteten
+ *
+ * \return true wenn beide Durchläufe dieselben, erwarteten Pfade in derselben Reihenfolge liefern
+ */
+static bool run_case(const test_case_t *test, const char *dir) {
+    myfind_options_t options;
+    myfind_expr_t *expr = NULL;
+    myfind_iter_t *iter = NULL;
+    matches_t run = {.count = 0};
+    matches_t iterated = {.count = 0};
+    const char *roots[] = {dir};
+    const char *path;
+    const struct stat *file_stat;
+    bool ok = true;
+
+    myfind_options_init(&options);
+    options.sort_name = test->sort_name;
+    options.jobs = test->jobs;
+    if (myfind_compile(test->args, &options, &expr) != MYFIND_OK_NOERROR)
+        return false;
+
+    myfind_retval_t result = myfind_run_roots(expr, roots, 1, collect, &run);
+    if (result != MYFIND_OK_NOERROR) {
+        fprintf(stderr, "myfind_run_roots() returned %d\n", result);
+        ok = false;
+    }
+
+    if (myfind_iter_open_roots(expr, roots, 1, &iter) != MYFIND_OK_NOERROR) {
+        ok = false;
+    } else {
+        while ((result = myfind_iter_next(iter, &path, &file_stat)) == MYFIND_OK_PROCEED) {
+            if (collect(path, file_stat, &iterated) != 0)
+                break;
+        }
+        if (result != MYFIND_OK_STOP || myfind_iter_close(iter) != MYFIND_OK_NOERROR) {
+            fprintf(stderr, "myfind_iter_next() returned %d\n", result);
+            ok = false;
+        }
+    }
+
+    if (run.count != iterated.count) {
+        fprintf(stderr, "callback delivered %lu paths, iterator %lu\n", (unsigned long)run.count,
+                (unsigned long)iterated.count);
+        ok = false;
+    }
+    for (size_t i = 0; i < run.count && i < iterated.count; i++) {
+        if (strcmp(run.paths[i], iterated.paths[i]) != 0) {
+            fprintf(stderr, "path %lu differs: '%s' != '%s'\n", (unsigned long)i, run.paths[i], iterated.paths[i]);
+            ok = false;
+        }
+    }
+    ok = check_expected(test, dir, &run) && ok;
+
+    matches_free(&run);
+    matches_free(&iterated);
+    myfind_free(expr);
+    return ok;
+}
+
+/**
+ * \brief Vergleicht die Treffer mit den erwarteten Pfaden des Testfalls.
+ *
+ * Mit sort_name muss auch die Reihenfolge stimmen, sonst werden die Treffer vorher sortiert.
+ *
+ * \param test der Testfall
+ * \param dir das Start-Verzeichnis
+ * \param matches die Treffer
+ *
+ * \return true wenn die Treffer den erwarteten entsprechen
+ */
+static bool check_expected(const test_case_t *test, const char *dir, const matches_t *matches) {
+    char expected[PATH_MAX_TEST];
+    char *sorted[MATCHES_MAX];
+    size_t count = 0;
+
+    memcpy(sorted, matches->paths, matches->count * sizeof(char *));
+    if (!test->sort_name)
+        qsort(sorted, matches->count, sizeof(char *), compare_paths);
+
+    for (; test->expected[count] != NULL; count++) {
+        snprintf(expected, sizeof(expected), "%s%s%s", dir, (test->expected[count][0] != '\0') ? "/" : "",
+                 test->expected[count]);
+        if (count >= matches->count || strcmp(sorted[count], expected) != 0) {
+            fprintf(stderr, "expected '%s', got '%s'\n", expected, (count < matches->count) ? sorted[count] : "");
+            return false;
+        }
+    }
+    if (count != matches->count) {
+        fprintf(stderr, "expected %lu paths, got %lu\n", (unsigned long)count, (unsigned long)matches->count);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Vergleichsfunktion für qsort(), sortiert Pfade byteweise wie LC_ALL=C sort
+ */
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}